@@ -0,0 +1,763 @@
+/*********************************************************************
+ * FILE NAME: DSBenchmark.c
+ * PURPOSE: Timings of the data structures under typical workloads.
+ * NOTES: Build with a ListType.h that makes Item an int, e.g.
+ *        cc -O2 -std=gnu11 -pthread -I. DSImplementation.c DSBenchmark.c
+ *        and run as
+ *        DSBenchmark [text | csv | json] [largest size]
+ *        which prints a table, CSV with a header line, or one JSON
+ *        object per line, for sizes from 100 up to the largest size
+ *        (10000000 by default). Each record gives a structure, a
+ *        workload, the order of the keys, a size, the average time
+ *        and number of allocations of one operation, and the peak
+ *        resident memory of the process that ran it. Run as
+ *        DSBenchmark check
+ *        it instead runs the stress checks and exits with status 1 if
+ *        any of them fails.
+ *********************************************************************/
+
+#include "DSInterface.h"
+#include "DSTemplate.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Reporting
+///////////////////////////////////////////////////////////////////////
+
+#define TEXT 0
+#define CSV 1
+#define JSON 2
+
+static int format=TEXT;
+static double phaseStart;
+static long phaseAllocations;
+
+/* Allocations made by the calling thread, and those of the threads
+ * runThreads has finished. */
+static _Thread_local long allocations;
+static _Atomic long threadAllocations;
+
+static double now (void) {
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC,&t);
+	return t.tv_sec+t.tv_nsec*1e-9;
+}
+
+
+/* Peak resident memory of the process, in kilobytes. */
+static long peakMemory (void) {
+	struct rusage usage;
+	
+	getrusage(RUSAGE_SELF,&usage);
+	return usage.ru_maxrss;
+}
+
+
+static void beginPhase (void) {
+	phaseAllocations=allocations+threadAllocations;
+	phaseStart=now();
+}
+
+
+/* Reports the phase begun last, which did a number of operations. */
+static void endPhase (const char *structure, const char *workload,
+				   const char *order, int n, long operations) {
+	double nanoseconds=(now()-phaseStart)/operations*1e9;
+	double allocationsPerOperation=(double)(allocations+threadAllocations-phaseAllocations)/operations;
+	
+	if(format==CSV)
+		printf("%s,%s,%s,%d,%.1f,%.3f,%ld\n",structure,workload,order,n,
+			   nanoseconds,allocationsPerOperation,peakMemory());
+	else if(format==JSON)
+		printf("{\"structure\":\"%s\",\"workload\":\"%s\",\"order\":\"%s\",\"n\":%d,"
+			   "\"ns_per_op\":%.1f,\"allocations_per_op\":%.3f,\"peak_rss_kb\":%ld}\n",
+			   structure,workload,order,n,nanoseconds,allocationsPerOperation,peakMemory());
+	else
+		printf("%-28s %-14s %-11s %9d %10.1f ns/op %7.2f allocs/op %9ld KB\n",structure,workload,
+			   order,n,nanoseconds,allocationsPerOperation,peakMemory());
+}
+
+
+/* Runs a benchmark in a child process, so that the peak memory it
+ * reports is its own. Returns 1 if the child finished, 0 if it
+ * crashed or failed. */
+static int isolate (void (*benchmark) (int, int), int order, int n) {
+	pid_t child;
+	int status;
+	
+	fflush(stdout);
+	child=fork();
+	if(child<0) benchmark(order,n);
+	else if(child==0) {
+		benchmark(order,n);
+		fflush(stdout);
+		_exit(0);
+	}
+	else {
+		if(waitpid(child,&status,0)<0) return 0;
+		return WIFEXITED(status) && WEXITSTATUS(status)==0;
+	}
+	return 1;
+}
+
+
+static void *countedAllocate (void *context, size_t size) {
+	allocations++;
+	return malloc(size);
+}
+
+
+static void countedRelease (void *context, void *p) {
+	free(p);
+}
+
+static Allocator counted={countedAllocate,countedRelease,NULL,NULL};
+
+static void *copyInt (void *dest, void *src) {
+	if(dest==NULL) {
+		dest=malloc(sizeof(int));
+		allocations++;
+	}
+	if(dest!=NULL) *(int *)dest=*(int *)src;
+	return dest;
+}
+
+
+static void destroyInt (void *I) {
+	free(I);
+}
+
+
+static int compareInts (void *a, void *b) {
+	int x=*(int *)a, y=*(int *)b;
+	return x<y ? -1 : x>y;
+}
+
+
+static int compareIntValues (int x, int y) {
+	return x<y ? -1 : x>y;
+}
+
+DS_DEFINE_HEAP(TemplateHeap, int, compareIntValues)
+
+///////////////////////////////////////////////////////////////////////
+
+
+// Structure Benchmarks
+///////////////////////////////////////////////////////////////////////
+
+#define SORTED 0
+#define RANDOM 1
+#define ADVERSARIAL 2
+
+/* Past these sizes the adversarial orders take quadratic time, as a
+ * List finds a position by walking and an unbalanced BST degrades
+ * to a path, so those cases are skipped. */
+#define LISTPOSITIONLIMIT 100000
+#define BSTDEGENERATELIMIT 10000
+
+static const char *orders[]={"sorted","random","adversarial"};
+
+/* Makes the keys 0 to n-1 in increasing order, in random order, or
+ * alternating between the least and greatest keys left, which turns
+ * an unbalanced BST into a zigzag path and has every other insert
+ * in a Heap sift up most of the way to the root. */
+static int *makeKeys (int order, int n) {
+	int *keys;
+	int i, j, k;
+	
+	keys=malloc(sizeof(int)*n);
+	if(keys==NULL) {
+		fprintf(stderr,"out of memory for %d keys\n",n);
+		exit(1);
+	}
+	for(i=0;i<n;i++) keys[i]=order==ADVERSARIAL ? (i%2==0 ? i/2 : n-1-i/2) : i;
+	if(order==RANDOM) {
+		srand(1);
+		for(i=n-1;i>0;i--) {
+			j=rand()%(i+1);
+			k=keys[i];
+			keys[i]=keys[j];
+			keys[j]=k;
+		}
+	}
+	return keys;
+}
+
+
+/* Picks where an operation on a List of a size happens, for each
+ * order: at the end, anywhere, or in the middle, the farthest from
+ * both ends. Lookups and deletes pass the size less one. */
+static int listPosition (int order, int size) {
+	if(order==SORTED) return size;
+	if(order==RANDOM) return rand()%(size+1);
+	return size/2;
+}
+
+
+static void benchmarkList (int order, int n) {
+	List L;
+	ListCursor C;
+	int i, k;
+	
+	if(order!=SORTED && n>LISTPOSITIONLIMIT) return;
+	initializeList(&L);
+	setAllocatorList(&L,&counted);
+	srand(1);
+	beginPhase();
+	for(i=0;i<n;i++) insertList(i,listPosition(order,i),&L);
+	endPhase("list","insert",orders[order],n,n);
+	beginPhase();
+	for(i=0;i<n;i++) peekList(listPosition(order,n-1),&L,&k);
+	endPhase("list","lookup",orders[order],n,n);
+	initializeListCursor(&C,&L);
+	beginPhase();
+	for(i=firstListCursor(&C);i;i=nextListCursor(&C)) peekListCursor(&C,&k);
+	endPhase("list","iterate",orders[order],n,n);
+	beginPhase();
+	for(i=n;i>0;i--) deleteList(listPosition(order,i-1),&L);
+	endPhase("list","delete",orders[order],n,n);
+	for(i=0;i<n;i++) appendList(i,&L);
+	beginPhase();
+	destroyList(&L);
+	endPhase("list","destroy",orders[order],n,n);
+}
+
+
+/* A Stack has no keys to order, so only the sorted order runs. */
+static void benchmarkStack (int order, int n) {
+	Stack S;
+	int i, k;
+	
+	if(order!=SORTED) return;
+	initializeStack(&S);
+	setAllocatorStack(&S,&counted);
+	beginPhase();
+	for(i=0;i<n;i++) pushStack(i,&S);
+	endPhase("stack","push",orders[order],n,n);
+	beginPhase();
+	for(i=0;i<n;i++) topStack(&S,&k);
+	endPhase("stack","top",orders[order],n,n);
+	beginPhase();
+	for(i=0;i<n;i++) popStack(&S);
+	endPhase("stack","pop",orders[order],n,n);
+	for(i=0;i<n;i++) pushStack(i,&S);
+	beginPhase();
+	destroyStack(&S);
+	endPhase("stack","destroy",orders[order],n,n);
+}
+
+
+typedef struct {
+	const char *name;
+	void (*initialize) (Tree *, void * (*) (void *, void *), void (*) (void *),
+					 int (*) (void *, void *));
+	void (*setAllocator) (Tree *, Allocator *);
+	void (*insert) (Tree *, void *);
+	int (*search) (Tree *, void *, void *);
+	int (*delete) (Tree *, void *);
+	void (*destroy) (Tree *);
+} TreeFunctions;
+
+static const TreeFunctions bst={"bst",initializeBST,setAllocatorBST,insertBST,searchBST,
+								deleteBST,destroyBST};
+static const TreeFunctions avl={"avl",initializeAVL,setAllocatorAVL,insertAVL,searchAVL,
+								deleteAVL,destroyAVL};
+
+static void benchmarkTree (const TreeFunctions *F, int order, int n) {
+	Tree T;
+	TreeCursor C;
+	int *keys;
+	int i, k;
+	
+	keys=makeKeys(order,n);
+	F->initialize(&T,copyInt,destroyInt,compareInts);
+	F->setAllocator(&T,&counted);
+	beginPhase();
+	for(i=0;i<n;i++) F->insert(&T,&keys[i]);
+	endPhase(F->name,"insert",orders[order],n,n);
+	beginPhase();
+	for(i=0;i<n;i++) F->search(&T,&keys[i],&k);
+	endPhase(F->name,"lookup",orders[order],n,n);
+	initializeTreeCursor(&C,&T);
+	beginPhase();
+	for(i=firstTreeCursor(&C);i;i=nextTreeCursor(&C)) k=*(int *)currentTreeCursor(&C);
+	endPhase(F->name,"iterate",orders[order],n,n);
+	beginPhase();
+	for(i=0;i<n;i++) F->delete(&T,&keys[i]);
+	endPhase(F->name,"delete",orders[order],n,n);
+	for(i=0;i<n;i++) F->insert(&T,&keys[i]);
+	beginPhase();
+	F->destroy(&T);
+	endPhase(F->name,"destroy",orders[order],n,n);
+	free(keys);
+}
+
+
+static void benchmarkBST (int order, int n) {
+	if(order!=RANDOM && n>BSTDEGENERATELIMIT) return;
+	benchmarkTree(&bst,order,n);
+}
+
+
+static void benchmarkAVL (int order, int n) {
+	benchmarkTree(&avl,order,n);
+}
+
+
+/* An Allocator would give up the cache-line alignment of the nodes,
+ * so only the copies of the items are counted. */
+static void benchmarkBTree (int order, int n) {
+	BTree T;
+	BTreeCursor C;
+	int *keys;
+	int i, k;
+	
+	keys=makeKeys(order,n);
+	initializeBTree(&T,copyInt,destroyInt,compareInts);
+	beginPhase();
+	for(i=0;i<n;i++) insertBTree(&T,&keys[i]);
+	endPhase("btree","insert",orders[order],n,n);
+	beginPhase();
+	for(i=0;i<n;i++) searchBTree(&T,&keys[i],&k);
+	endPhase("btree","lookup",orders[order],n,n);
+	initializeBTreeCursor(&C,&T);
+	beginPhase();
+	for(i=firstBTreeCursor(&C);i;i=nextBTreeCursor(&C)) k=*(int *)currentBTreeCursor(&C);
+	endPhase("btree","iterate",orders[order],n,n);
+	beginPhase();
+	for(i=0;i<n;i++) deleteBTree(&T,&keys[i]);
+	endPhase("btree","delete",orders[order],n,n);
+	for(i=0;i<n;i++) insertBTree(&T,&keys[i]);
+	beginPhase();
+	destroyBTree(&T);
+	endPhase("btree","destroy",orders[order],n,n);
+	free(keys);
+}
+
+
+/* A Heap cannot be walked in order, so it has no iterate phase. As
+ * with a BTree, an Allocator would give up the cache-line layout of
+ * the array, so only the copies of the items are counted. */
+static void benchmarkHeap (int order, int n) {
+	Heap H;
+	int *keys;
+	int i, k;
+	
+	keys=makeKeys(order,n);
+	initializeHeap(&H,0,copyInt,destroyInt,compareInts);
+	beginPhase();
+	for(i=0;i<n;i++) insertHeap(&H,&keys[i]);
+	endPhase("heap","insert",orders[order],n,n);
+	beginPhase();
+	for(i=0;i<n;i++) topHeap(&H,&k);
+	endPhase("heap","top",orders[order],n,n);
+	beginPhase();
+	for(i=0;i<n;i++) removeHeap(&H);
+	endPhase("heap","delete",orders[order],n,n);
+	for(i=0;i<n;i++) insertHeap(&H,&keys[i]);
+	beginPhase();
+	destroyHeap(&H);
+	endPhase("heap","destroy",orders[order],n,n);
+	free(keys);
+}
+
+
+/* Returns 1 if every benchmark finished, 0 otherwise. */
+static int benchmarkStructures (int largest) {
+	static void (*const benchmarks[]) (int, int)={benchmarkList,benchmarkStack,benchmarkBST,
+											   benchmarkAVL,benchmarkBTree,benchmarkHeap};
+	int b, order, finished=1;
+	long n;
+	
+	for(b=0;b<6;b++)
+		for(n=100;n<=largest;n*=10)
+			for(order=SORTED;order<=ADVERSARIAL;order++)
+				if(!isolate(benchmarks[b],order,n)) finished=0;
+	return finished;
+}
+
+///////////////////////////////////////////////////////////////////////
+
+
+// Heap Benchmarks
+///////////////////////////////////////////////////////////////////////
+
+/* Sets up a Heap of ints for n items, stored either as copies
+ * or inline. */
+static void initializeIntHeap (Heap *H, int n, int arity, int inlineItems) {
+	if(inlineItems) initializeInlineHeap(H,n,sizeof(int),compareInts);
+	else initializeHeap(H,n,copyInt,destroyInt,compareInts);
+	setArityHeap(H,arity);
+}
+
+
+/* Pushes n random items and pops them all. */
+static void pushPopHeap (int arity, int inlineItems, int n) {
+	Heap H;
+	char name[40];
+	int i, k;
+
+	initializeIntHeap(&H,n,arity,inlineItems);
+	srand(1);
+	beginPhase();
+	for(i=0;i<n;i++) {
+		k=rand();
+		insertHeap(&H,&k);
+	}
+	while(!emptyHeap(&H)) removeHeap(&H);
+	sprintf(name,"heap %d-ary%s",arity,inlineItems ? " inline" : "");
+	endPhase(name,"push+pop","random",n,2L*n);
+	destroyHeap(&H);
+}
+
+
+/* Keeps n items and replaces the largest one with a random item,
+ * as a scheduler or a merge of n runs would. */
+static void replaceTopHeap (int arity, int inlineItems, int n) {
+	Heap H;
+	char name[40];
+	int i, k;
+
+	initializeIntHeap(&H,n,arity,inlineItems);
+	srand(1);
+	for(i=0;i<n;i++) {
+		k=rand();
+		insertHeap(&H,&k);
+	}
+	beginPhase();
+	for(i=0;i<n;i++) {
+		removeHeap(&H);
+		k=rand();
+		insertHeap(&H,&k);
+	}
+	sprintf(name,"heap %d-ary%s",arity,inlineItems ? " inline" : "");
+	endPhase(name,"replace top","random",n,n);
+	destroyHeap(&H);
+}
+
+
+/* Does what pushPopHeap and replaceTopHeap do on a Heap defined by
+ * DS_DEFINE_HEAP, whose compare is inlined. */
+static void templateHeap (int n) {
+	TemplateHeap H;
+	int i;
+	
+	initializeTemplateHeap(&H);
+	reserveTemplateHeap(&H,n);
+	srand(1);
+	beginPhase();
+	for(i=0;i<n;i++) insertTemplateHeap(&H,rand());
+	while(!emptyTemplateHeap(&H)) removeTemplateHeap(&H);
+	endPhase("heap template","push+pop","random",n,2L*n);
+	for(i=0;i<n;i++) insertTemplateHeap(&H,rand());
+	beginPhase();
+	for(i=0;i<n;i++) {
+		removeTemplateHeap(&H);
+		insertTemplateHeap(&H,rand());
+	}
+	endPhase("heap template","replace top","random",n,n);
+	destroyTemplateHeap(&H);
+}
+
+
+#define TOPK 100
+#define TOPKITEMS 10000000
+
+/* Keeps the TOPK largest of n random items, as a streaming top-K
+ * does. */
+static void benchmarkTopKHeap (int order, int n) {
+	Heap H;
+	char name[40];
+	int i, item;
+
+	if(order!=RANDOM) return;
+	initializeInlineHeap(&H,TOPK,sizeof(int),compareInts);
+	setBoundHeap(&H,TOPK);
+	srand(1);
+	beginPhase();
+	for(i=0;i<n;i++) {
+		item=rand();
+		insertHeap(&H,&item);
+	}
+	sprintf(name,"heap top-%d inline",TOPK);
+	endPhase(name,"insert",orders[order],n,n);
+	destroyHeap(&H);
+}
+
+
+/* The layouts are compared on random items only. */
+static void benchmarkHeapLayouts (int order, int n) {
+	static const int arities[]={2,4,8,16};
+	int a, inlineItems;
+
+	if(order!=RANDOM) return;
+	for(inlineItems=0;inlineItems<2;inlineItems++)
+		for(a=0;a<4;a++) {
+			pushPopHeap(arities[a],inlineItems,n);
+			replaceTopHeap(arities[a],inlineItems,n);
+		}
+	templateHeap(n);
+}
+
+
+/* Compares the layouts on ten thousand items, which fit in cache,
+ * and on a million, which do not, and times a top-K, each as far as
+ * the largest size allows. Returns 1 if every benchmark finished,
+ * 0 otherwise. */
+static int benchmarkHeaps (int largest) {
+	int n, finished=1;
+
+	for(n=10000;n<=1000000;n*=100) {
+		if(!isolate(benchmarkHeapLayouts,RANDOM,n<largest ? n : largest)) finished=0;
+		if(n>=largest) break;
+	}
+	if(!isolate(benchmarkTopKHeap,RANDOM,TOPKITEMS<largest ? TOPKITEMS : largest)) finished=0;
+	return finished;
+}
+
+///////////////////////////////////////////////////////////////////////
+
+
+// Concurrent Heap Benchmarks
+///////////////////////////////////////////////////////////////////////
+
+#define CONCURRENTOPERATIONS 1000000
+#define CONCURRENTHEAPITEMS 10000
+
+static Heap sharedHeap;
+static pthread_mutex_t sharedLock=PTHREAD_MUTEX_INITIALIZER;
+static ConcurrentHeap concurrentHeap;
+
+/* Each thread inserts an item and removes one, over and over, as
+ * the workers of a scheduler do. */
+static void *lockedHeapWorker (void *operations) {
+	unsigned int seed=(unsigned int)(size_t)&seed;
+	int i, k;
+
+	for(i=0;i<*(int *)operations;i++) {
+		k=rand_r(&seed);
+		pthread_mutex_lock(&sharedLock);
+		insertHeap(&sharedHeap,&k);
+		pthread_mutex_unlock(&sharedLock);
+		pthread_mutex_lock(&sharedLock);
+		removeHeap(&sharedHeap);
+		pthread_mutex_unlock(&sharedLock);
+	}
+	return NULL;
+}
+
+
+static void *concurrentHeapWorker (void *operations) {
+	unsigned int seed=(unsigned int)(size_t)&seed;
+	int i, k;
+
+	for(i=0;i<*(int *)operations;i++) {
+		k=rand_r(&seed);
+		insertConcurrentHeap(&concurrentHeap,&k);
+		removeConcurrentHeap(&concurrentHeap,&k);
+	}
+	return NULL;
+}
+
+
+typedef struct {
+	void * (*worker) (void *);
+	int operations;
+} ThreadTask;
+
+/* Runs the worker of a task and adds up the allocations it made. */
+static void *runTask (void *task) {
+	ThreadTask *T=task;
+
+	T->worker(&T->operations);
+	threadAllocations+=allocations;
+	return NULL;
+}
+
+
+/* Begins a phase that runs a worker on a number of threads that
+ * share the operations, and waits for them. */
+static void runThreads (void * (*worker) (void *), int threads) {
+	pthread_t thread[64];
+	ThreadTask task={worker,CONCURRENTOPERATIONS/threads};
+	int i;
+
+	beginPhase();
+	for(i=0;i<threads;i++) pthread_create(&thread[i],NULL,runTask,&task);
+	for(i=0;i<threads;i++) pthread_join(thread[i],NULL);
+}
+
+
+/* Times heaps that start with n random items. */
+static void benchmarkConcurrentHeap (int order, int n) {
+	static const int threads[]={1,2,4,8};
+	char name[40];
+	int t, i, k;
+
+	if(order!=RANDOM) return;
+	for(t=0;t<4;t++) {
+		initializeHeap(&sharedHeap,0,copyInt,destroyInt,compareInts);
+		initializeConcurrentHeap(&concurrentHeap,4*threads[t],copyInt,destroyInt,compareInts);
+		srand(1);
+		for(i=0;i<n;i++) {
+			k=rand();
+			insertHeap(&sharedHeap,&k);
+			insertConcurrentHeap(&concurrentHeap,&k);
+		}
+		runThreads(lockedHeapWorker,threads[t]);
+		sprintf(name,"locked heap %d threads",threads[t]);
+		endPhase(name,"insert+remove",orders[order],n,2L*CONCURRENTOPERATIONS);
+		runThreads(concurrentHeapWorker,threads[t]);
+		sprintf(name,"concurrent heap %d threads",threads[t]);
+		endPhase(name,"insert+remove",orders[order],n,2L*CONCURRENTOPERATIONS);
+		destroyHeap(&sharedHeap);
+		destroyConcurrentHeap(&concurrentHeap);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////
+
+// Concurrent Stack Benchmarks
+///////////////////////////////////////////////////////////////////////
+
+#define CONCURRENTSTACKITEMS 1000
+#define STRESSTHREADS 4
+#define STRESSITEMS 250000
+
+static Stack sharedStack;
+static ConcurrentStack concurrentStack;
+static _Atomic int *popped;
+
+/* Pushes the items first to first+STRESSITEMS-1 and pops one item
+ * after every other push, counting each item popped. */
+static void *stressWorker (void *first) {
+	int i, k;
+	
+	for(i=0;i<STRESSITEMS;i++) {
+		if(!pushConcurrentStack(*(int *)first+i,&concurrentStack)) return NULL;
+		if(i%2==1 && popConcurrentStack(&concurrentStack,&k)) atomic_fetch_add(&popped[k],1);
+	}
+	return NULL;
+}
+
+
+/* Checks that every item pushed by a number of threads is popped
+ * exactly once, by them or after they are done. Returns 1 if so,
+ * 0 otherwise. */
+static int stressConcurrentStack (void) {
+	pthread_t thread[STRESSTHREADS];
+	int first[STRESSTHREADS];
+	int i, k, n=STRESSTHREADS*STRESSITEMS, failed=0;
+	
+	popped=calloc(n,sizeof(*popped));
+	if(popped==NULL || !initializeConcurrentStack(&concurrentStack,n)) {
+		fprintf(stderr,"concurrent stack stress check could not start\n");
+		free(popped);
+		return 0;
+	}
+	for(i=0;i<STRESSTHREADS;i++) {
+		first[i]=i*STRESSITEMS;
+		pthread_create(&thread[i],NULL,stressWorker,&first[i]);
+	}
+	for(i=0;i<STRESSTHREADS;i++) pthread_join(thread[i],NULL);
+	while(popConcurrentStack(&concurrentStack,&k)) popped[k]++;
+	for(i=0;i<n;i++) if(popped[i]!=1) failed++;
+	fprintf(stderr,"concurrent stack stress check %s (%d of %d items lost or repeated)\n",
+		   failed ? "FAILED" : "passed",failed,n);
+	destroyConcurrentStack(&concurrentStack);
+	free(popped);
+	return !failed;
+}
+
+
+/* Each thread pushes an item and pops one, over and over, as the
+ * workers sharing a free list do. */
+static void *lockedStackWorker (void *operations) {
+	int i, k;
+	
+	for(i=0;i<*(int *)operations;i++) {
+		pthread_mutex_lock(&sharedLock);
+		pushStack(i,&sharedStack);
+		pthread_mutex_unlock(&sharedLock);
+		pthread_mutex_lock(&sharedLock);
+		topStack(&sharedStack,&k);
+		popStack(&sharedStack);
+		pthread_mutex_unlock(&sharedLock);
+	}
+	return NULL;
+}
+
+
+static void *concurrentStackWorker (void *operations) {
+	int i, k;
+	
+	for(i=0;i<*(int *)operations;i++) {
+		pushConcurrentStack(i,&concurrentStack);
+		popConcurrentStack(&concurrentStack,&k);
+	}
+	return NULL;
+}
+
+
+/* Times stacks that start with n items. As with benchmarkStack,
+ * only the sorted order runs. */
+static void benchmarkConcurrentStack (int order, int n) {
+	static const int threads[]={1,2,4,8};
+	char name[40];
+	int t, i;
+	
+	if(order!=SORTED) return;
+	for(t=0;t<4;t++) {
+		initializeStack(&sharedStack);
+		initializeConcurrentStack(&concurrentStack,n+threads[t]);
+		for(i=0;i<n;i++) {
+			pushStack(i,&sharedStack);
+			pushConcurrentStack(i,&concurrentStack);
+		}
+		runThreads(lockedStackWorker,threads[t]);
+		sprintf(name,"locked stack %d threads",threads[t]);
+		endPhase(name,"push+pop",orders[order],n,2L*CONCURRENTOPERATIONS);
+		runThreads(concurrentStackWorker,threads[t]);
+		sprintf(name,"concurrent stack %d threads",threads[t]);
+		endPhase(name,"push+pop",orders[order],n,2L*CONCURRENTOPERATIONS);
+		destroyStack(&sharedStack);
+		destroyConcurrentStack(&concurrentStack);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////
+
+
+int main (int argc, char **argv) {
+	int i, largest=10000000, finished;
+	char *end;
+	
+	if(argc==2 && strcmp(argv[1],"check")==0) return !stressConcurrentStack();
+	for(i=1;i<argc;i++) {
+		if(strcmp(argv[i],"text")==0) format=TEXT;
+		else if(strcmp(argv[i],"csv")==0) format=CSV;
+		else if(strcmp(argv[i],"json")==0) format=JSON;
+		else {
+			largest=(int)strtol(argv[i],&end,10);
+			if(*end!='\0' || largest<100) {
+				fprintf(stderr,"usage: %s [text | csv | json] [largest size]\n"
+						"       %s check\n",argv[0],argv[0]);
+				return 1;
+			}
+		}
+	}
+	if(format==CSV) printf("structure,workload,order,n,ns_per_op,allocations_per_op,peak_rss_kb\n");
+	finished=benchmarkStructures(largest);
+	finished&=benchmarkHeaps(largest);
+	finished&=isolate(benchmarkConcurrentHeap,RANDOM,
+					  CONCURRENTHEAPITEMS<largest ? CONCURRENTHEAPITEMS : largest);
+	finished&=isolate(benchmarkConcurrentStack,SORTED,
+					  CONCURRENTSTACKITEMS<largest ? CONCURRENTSTACKITEMS : largest);
+	return !finished;
+}
@@ -8,10 +8,155 @@
 #include <stdio.h>
 #include <assert.h>
 
+/* With DSSTATISTICS defined, Trees and Heaps count what they do in
+ * their statistics field; otherwise the counting compiles to
+ * nothing and the stats functions give zeros. */
+#ifdef DSSTATISTICS
+#define COUNTSTATISTIC(S,field) ((S)->statistics.field++)
+#define ADDSTATISTIC(S,field,n) ((S)->statistics.field+=(n))
+#define DEPTHSTATISTIC(S,depth) recordDepth(&(S)->statistics,depth)
+#define CLEARSTATISTICS(S) memset(&(S)->statistics,0,sizeof(Statistics))
+#define STATISTICS(S) ((S)->statistics)
+
+static void recordDepth (Statistics *S, int depth) {
+	S->descents++;
+	S->totalDepth+=depth;
+	if(depth>S->maxDepth) S->maxDepth=depth;
+}
+#else
+#define COUNTSTATISTIC(S,field) ((void)0)
+#define ADDSTATISTIC(S,field,n) ((void)0)
+#define DEPTHSTATISTIC(S,depth) ((void)0)
+#define CLEARSTATISTICS(S) ((void)0)
+#define STATISTICS(S) noStatistics
+
+static const Statistics noStatistics;
+#endif
+
+// Pool Implementation
+///////////////////////////////////////////////////////////////////////
+
+#define POOLALIGNMENT _Alignof(max_align_t)
+#define POOLHEADER ((sizeof(void *)+POOLALIGNMENT-1)/POOLALIGNMENT*POOLALIGNMENT)
+
+static void *allocateMemory (Allocator *A, size_t size) {
+	if(A==NULL) return malloc(size);
+	return A->allocate(A->context,size);
+}
+
+
+static void releaseMemory (Allocator *A, void *p) {
+	if(A==NULL) free(p);
+	else A->release(A->context,p);
+}
+
+
+/* Moves a block of oldSize bytes to one of newSize bytes, keeping
+ * what fits. */
+static void *resizeMemory (Allocator *A, void *p, size_t oldSize, size_t newSize) {
+	void *q;
+	
+	if(A==NULL) return realloc(p,newSize);
+	q=allocateMemory(A,newSize);
+	if(q!=NULL) {
+		memcpy(q,p,oldSize<newSize ? oldSize : newSize);
+		releaseMemory(A,p);
+	}
+	return q;
+}
+
+
+/* Whether Destroy may hand all nodes back at once instead of
+ * releasing them one at a time. */
+static int releasesAll (Allocator *A) {
+	return A!=NULL && A->releaseAll!=NULL;
+}
+
+
+static void *allocatePoolObject (void *context, size_t size) {
+	Pool *P=context;
+	char *page;
+	void *p;
+	
+	if(P->objectSize==0) {
+		if(size<sizeof(void *)) size=sizeof(void *);
+		P->objectSize=(size+POOLALIGNMENT-1)/POOLALIGNMENT*POOLALIGNMENT;
+	}
+	if(size>P->objectSize) return NULL;
+	if(P->freeObjects!=NULL) {
+		p=P->freeObjects;
+		P->freeObjects=*(void **)p;
+		return p;
+	}
+	if(P->remaining==0) {
+		page=malloc(POOLHEADER+P->objectSize*P->objectsPerPage);
+		if(page==NULL) return NULL;
+		*(void **)page=P->pages;
+		P->pages=page;
+		P->next=page+POOLHEADER;
+		P->remaining=P->objectsPerPage;
+	}
+	p=P->next;
+	P->next+=P->objectSize;
+	P->remaining--;
+	return p;
+}
+
+
+static void releasePoolObject (void *context, void *p) {
+	Pool *P=context;
+	*(void **)p=P->freeObjects;
+	P->freeObjects=p;
+}
+
+
+static void releasePoolPages (void *context) {
+	Pool *P=context;
+	void *page;
+	
+	while(P->pages!=NULL) {
+		page=P->pages;
+		P->pages=*(void **)page;
+		free(page);
+	}
+	P->freeObjects=NULL;
+	P->next=NULL;
+	P->remaining=0;
+}
+
+
+void initializePool (Pool *P, int objectsPerPage) {
+	assert(objectsPerPage > 0);
+	P->objectSize=0;
+	P->objectsPerPage=objectsPerPage;
+	P->pages=NULL;
+	P->freeObjects=NULL;
+	P->next=NULL;
+	P->remaining=0;
+	P->allocator.allocate=allocatePoolObject;
+	P->allocator.release=releasePoolObject;
+	P->allocator.releaseAll=releasePoolPages;
+	P->allocator.context=P;
+}
+
+
+Allocator *allocatorPool (Pool *P) {
+	return &P->allocator;
+}
+
+
+void destroyPool (Pool *P) {
+	releasePoolPages(P);
+}
+
+///////////////////////////////////////////////////////////////////////
+
+
 // Linked-List Implementation
 ///////////////////////////////////////////////////////////////////////
 
 static void copyListItem (Item *Y, Item X) {
+	*Y=X;
 // Chenge to item ----------> InitializeItem(NameOfItem(X),Y);
 }
 
@@ -21,77 +166,223 @@ static void destroyListItem (Item *X) {
 }
 
 
-static ListNode *moveListTo (int position, List *L) {
-	int i;
-	ListNode *p=L->first;
-	for(i=0;i<position;i++) p=p->next;
-	return p;
+/* Finds the chunk that holds a position, skipping whole chunks from
+ * whichever end of the List is closer, and the offset of the
+ * position in it. The length is found at the end of the last chunk. */
+static ListChunk *moveListTo (int position, List *L, int *offset) {
+	ListChunk *c;
+	int start;
+	
+	start=L->size-L->last->count;
+	if(position>=start) {
+		*offset=position-start;
+		return L->last;
+	}
+	if(position<=L->size/2) {
+		c=L->first;
+		while(position>=c->count) {
+			position-=c->count;
+			c=c->next;
+		}
+		*offset=position;
+		return c;
+	}
+	c=L->last;
+	while(position<start) {
+		c=c->prev;
+		start-=c->count;
+	}
+	*offset=position-start;
+	return c;
+}
+
+
+/* The size of a chunk of a List, which holds a single Item in a
+ * doubly-linked List. */
+static size_t listChunkSize (List *L) {
+	return offsetof(ListChunk,items)+sizeof(Item)*L->chunkCapacity;
+}
+
+
+/* Links a new empty chunk in after c, or first if c is NULL. */
+static ListChunk *newListChunk (ListChunk *c, List *L) {
+	ListChunk *d;
+	
+	d=(ListChunk *)allocateMemory(L->allocator,listChunkSize(L));
+	d->count=0;
+	d->prev=c;
+	d->next=c==NULL ? L->first : c->next;
+	if(d->next!=NULL) d->next->prev=d;
+	else L->last=d;
+	if(c!=NULL) c->next=d;
+	else L->first=d;
+	return d;
+}
+
+
+static void freeListChunk (ListChunk *c, List *L) {
+	if(c->prev!=NULL) c->prev->next=c->next;
+	else L->first=c->next;
+	if(c->next!=NULL) c->next->prev=c->prev;
+	else L->last=c->prev;
+	releaseMemory(L->allocator,c);
+}
+
+
+/* Inserts an Item at an offset of a chunk, splitting the chunk if
+ * it is full; the chunk and offset then give where the Item went.
+ * At either end of a full chunk a new chunk is started instead, so
+ * a chunk of a single Item never splits. */
+static void insertInChunk (Item X, ListChunk **c, int *offset, List *L) {
+	ListChunk *d;
+	int half, capacity=L->chunkCapacity;
+	
+	if((*c)->count==capacity) {
+		if(*offset==0) *c=newListChunk((*c)->prev,L);
+		else if(*offset==capacity) {
+			*c=newListChunk(*c,L);
+			*offset=0;
+		} else {
+			d=newListChunk(*c,L);
+			half=capacity/2;
+			memcpy(d->items,(*c)->items+half,sizeof(Item)*(capacity-half));
+			d->count=capacity-half;
+			(*c)->count=half;
+			if(*offset>half) {
+				*c=d;
+				*offset-=half;
+			}
+		}
+	}
+	memmove((*c)->items+*offset+1,(*c)->items+*offset,sizeof(Item)*((*c)->count-*offset));
+	copyListItem(&(*c)->items[*offset],X);
+	(*c)->count++;
+	L->size++;
+}
+
+
+/* Deletes the Item at an offset of a chunk; the chunk and offset
+ * then give the Item that followed it, with a NULL chunk past the
+ * end of the List. A chunk that falls under half full is merged
+ * with a neighbour when their Items fit in one chunk. */
+static void deleteInChunk (ListChunk **c, int *offset, List *L) {
+	ListChunk *d, *e=*c;
+	
+	destroyListItem(&e->items[*offset]);
+	memmove(e->items+*offset,e->items+*offset+1,sizeof(Item)*(e->count-*offset-1));
+	e->count--;
+	L->size--;
+	if(e->count==0) {
+		*c=e->next;
+		*offset=0;
+		freeListChunk(e,L);
+		return;
+	}
+	if(e->count<L->chunkCapacity/2) {
+		if(e->next!=NULL && e->count+e->next->count<=L->chunkCapacity) d=e->next;
+		else if(e->prev!=NULL && e->prev->count+e->count<=L->chunkCapacity) {
+			d=e;
+			e=e->prev;
+			*c=e;
+			*offset+=e->count;
+		}
+		else d=NULL;
+		if(d!=NULL) {
+			memcpy(e->items+e->count,d->items,sizeof(Item)*d->count);
+			e->count+=d->count;
+			freeListChunk(d,L);
+		}
+	}
+	if(*offset==(*c)->count) {
+		*c=(*c)->next;
+		*offset=0;
+	}
 }
 
 void initializeList (List *L) {
 	L->size=0;
 	L->first=NULL;
+	L->last=NULL;
+	L->chunkCapacity=LISTCHUNKSIZE;
+	L->allocator=NULL;
     assert(emptyList(L));
     assert(!fullList(L));
     assert(lengthList(L) == 0);
 }
 
+void initializeDoublyList (List *L) {
+	initializeList(L);
+	L->chunkCapacity=1;
+}
+
+void setAllocatorList (List *L, Allocator *A) {
+    assert(emptyList(L));
+	L->allocator=A;
+}
+
 void insertList (Item X, int position, List *L) { 
     assert(position >= 0 );
     assert(position <= lengthList(L));
     assert(!fullList(L));
 
-	ListNode *p, *q;
+	ListChunk *c;
+	int offset;
 	int oldLength = lengthList(L);
-	L->size++;
-	q=(ListNode *)malloc(sizeof(ListNode));
-	copyListItem(&q->item,X);
-			 
-	if(position==0) {
-		q->next=L->first;
-		L->first=q;
-	} else {
-		p=moveListTo(position-1,L);
-		q->next=p->next;
-		p->next=q;
-	}
-    
-    Item peekTemp;
-    peekList(position, L, &peekTemp);
+	
+	if(L->size==0) newListChunk(NULL,L);
+	c=moveListTo(position,L,&offset);
+	insertInChunk(X,&c,&offset,L);
     
     assert(!emptyList(L));
     assert(lengthList(L) == oldLength+1);
 }
 
+ListChunk *appendList (Item X, List *L) {
+	ListChunk *c=L->last;
+	
+	if(c==NULL || c->count==L->chunkCapacity) c=newListChunk(c,L);
+	copyListItem(&c->items[c->count],X);
+	c->count++;
+	L->size++;
+	return c;
+}
+
+ListChunk *nodeList (int position, List *L) {
+    assert(position >= 0 );
+    assert(position < lengthList(L));
+
+	int offset;
+	return moveListTo(position,L,&offset);
+}
+
 void deleteList (int position, List *L) {
     assert(position >= 0 );
-    assert(position <= lengthList(L));
+    assert(position < lengthList(L));
     assert(lengthList(L) > 0);
     
-	ListNode *p, *q;
-    
+	ListChunk *c;
+	int offset;
     int oldLength = lengthList(L);
 	
-	if(position==0) {
-		q=L->first;
-		L->first=q->next;
-	} else {
-		p=moveListTo(position-1,L);
-		q=p->next;
-		p->next=q->next;
-	}
-	
-	destroyListItem(&q->item);
-	free(q);
-	L->size--;
+	c=moveListTo(position,L,&offset);
+	deleteInChunk(&c,&offset,L);
     
     assert(!fullList(L));
     assert(lengthList(L) == oldLength-1);
 }
 
+void unlinkList (ListChunk *N, List *L) {
+    assert(L->chunkCapacity == 1);
+    assert(N->count == 1);
+    
+	destroyListItem(&N->items[0]);
+	L->size--;
+	freeListChunk(N,L);
+}
+
 
 int fullList (List *L) {
-	return L->size==MAXLISTSIZE;
+	return 0;
 }
 
 
@@ -106,498 +397,2110 @@ int lengthList (List *L) {
 
 void peekList (int position, List *L, Item *X) {
     assert(position >= 0 );
-    assert(position <= lengthList(L));
+    assert(position < lengthList(L));
     assert(lengthList(L) > 0);
 
-	ListNode *p;
-	p=moveListTo(position,L);
-	copyListItem(X,p->item);
+	ListChunk *c;
+	int offset;
+	c=moveListTo(position,L,&offset);
+	copyListItem(X,c->items[offset]);
 }
 
 
 void destroyList (List *L) {
     
 	int i;
-	ListNode *p, *q;
+	ListChunk *c, *d;
 	
-	p=L->first;
-	for(i=0;i<L->size;i++) {
-		q=p;
-		p=p->next;
-		destroyListItem(&q->item);
-		free(q);
+	c=L->first;
+	while(c!=NULL) {
+		d=c;
+		c=c->next;
+		for(i=0;i<d->count;i++) destroyListItem(&d->items[i]);
+		if(!releasesAll(L->allocator)) releaseMemory(L->allocator,d);
 	}
+	if(releasesAll(L->allocator)) L->allocator->releaseAll(L->allocator->context);
 }
 
-void reverseList (List *L) {
+/* Appends an Item to the List being built by sortList, taking its
+ * chunks from those the merge is done with while there are any. */
+static void putListItem (Item *X, List *L, ListChunk **spare) {
+	ListChunk *c=L->last;
+	
+	if(c==NULL || c->count==L->chunkCapacity) {
+		if(*spare!=NULL) {
+			c=*spare;
+			*spare=c->next;
+		}
+		else c=(ListChunk *)allocateMemory(L->allocator,listChunkSize(L));
+		c->count=0;
+		c->next=NULL;
+		c->prev=L->last;
+		if(L->last!=NULL) L->last->next=c;
+		else L->first=c;
+		L->last=c;
+	}
+	c->items[c->count++]=*X;
+}
+
+
+/* Moves a reader of a run of chunks to its next Item, handing each
+ * chunk it leaves over to the spare ones; the reader stops at NULL
+ * after its last chunk. */
+static void nextListItem (ListChunk **c, int *index, int *chunks, ListChunk **spare) {
+	ListChunk *next;
+	
+	if(++*index<(*c)->count) return;
+	next=(*c)->next;
+	(*c)->next=*spare;
+	*spare=*c;
+	*c=--*chunks>0 ? next : NULL;
+	*index=0;
+}
+
+
+/* Finds the chunk a number of chunks after c, or NULL. */
+static ListChunk *skipListChunks (ListChunk *c, int chunks) {
+	while(c!=NULL && chunks-->0) c=c->next;
+	return c;
+}
+
+
+/* Merges the sorted runs of chunks that start at a and b onto the
+ * end of L, keeping Items of a first when they are equal. */
+static void mergeListRuns (ListChunk *a, ListChunk *b, int chunks, List *L,
+						ListChunk **spare, int (*compareItems) (Item *, Item *)) {
+	int i=0, j=0, na=chunks, nb=chunks;
+	
+	while(a!=NULL && b!=NULL)
+		if(compareItems(&b->items[j],&a->items[i])<0) {
+			putListItem(&b->items[j],L,spare);
+			nextListItem(&b,&j,&nb,spare);
+		}
+		else {
+			putListItem(&a->items[i],L,spare);
+			nextListItem(&a,&i,&na,spare);
+		}
+	for(;a!=NULL;nextListItem(&a,&i,&na,spare)) putListItem(&a->items[i],L,spare);
+	for(;b!=NULL;nextListItem(&b,&j,&nb,spare)) putListItem(&b->items[j],L,spare);
+}
+
+void sortList (List *L, int (*compareItems) (Item *, Item *)) {
     assert(L != NULL);
     
-    ListNode *head, *remainder;
-    List tempRest;
-    
-    head = L->first;
-    remainder = head->next;
-    if (remainder == NULL)
-        return;
-    tempRest.first = remainder;
+	ListChunk *c, *a, *b, *spare=NULL;
+	Item item;
+	int i, j, width;
+	
+	/* Packs the Items so that every chunk but the last is full; runs
+	 * then start and end on chunk boundaries. */
+	for(c=L->first;c!=L->last && c->count==L->chunkCapacity;c=c->next);
+	if(c!=L->last) {
+		c=L->first;
+		L->first=L->last=NULL;
+		i=0;
+		j=L->size;
+		while(c!=NULL) {
+			putListItem(&c->items[i],L,&spare);
+			nextListItem(&c,&i,&j,&spare);
+		}
+	}
+	for(c=L->first;c!=NULL;c=c->next)
+		for(i=1;i<c->count;i++) {
+			item=c->items[i];
+			for(j=i;j>0 && compareItems(&item,&c->items[j-1])<0;j--) c->items[j]=c->items[j-1];
+			c->items[j]=item;
+		}
+	for(width=1;width*L->chunkCapacity<L->size;width*=2) {
+		c=L->first;
+		L->first=L->last=NULL;
+		while(c!=NULL) {
+			a=c;
+			b=skipListChunks(a,width);
+			if(b==NULL) {
+				a->prev=L->last;
+				if(L->last!=NULL) L->last->next=a;
+				else L->first=a;
+				for(L->last=a;L->last->next!=NULL;L->last=L->last->next);
+				break;
+			}
+			c=skipListChunks(b,width);
+			mergeListRuns(a,b,width,L,&spare,compareItems);
+		}
+	}
+	while(spare!=NULL) {
+		c=spare;
+		spare=spare->next;
+		releaseMemory(L->allocator,c);
+	}
+}
+
+void reverseList (List *L) {
+    assert(L != NULL);
     
-    reverseList(&tempRest);
+    ListChunk *c, *temp;
+    Item item;
+    int i;
     
-    head->next->next = head;
-    head->next = NULL;    
-    L->first = tempRest.first;
+    for (c = L->first; c != NULL; c = c->prev) {
+        for (i = 0; i < c->count/2; i++) {
+            item = c->items[i];
+            c->items[i] = c->items[c->count-1-i];
+            c->items[c->count-1-i] = item;
+        }
+        temp = c->next;
+        c->next = c->prev;
+        c->prev = temp;
+    }
+    temp = L->first;
+    L->first = L->last;
+    L->last = temp;
 }
 
 ///////////////////////////////////////////////////////////////////////
 
 
-// AVL Tree Implementation
+// List Cursor Implementation
 ///////////////////////////////////////////////////////////////////////
 
-static void copyStackItem (Item *Y, Item X) {
-// Chenge to item ----------> InitializeItem(NameOfItem(X),Y);
+void initializeListCursor (ListCursor *C, List *L) {
+	C->list=L;
+	C->chunk=NULL;
+	C->index=0;
 }
 
 
-static void destroyStackItem (Item *X) {
-// Chenge to item ----------> FreeItem(X);
+int firstListCursor (ListCursor *C) {
+	C->chunk=C->list->first;
+	C->index=0;
+	return C->chunk!=NULL;
 }
 
 
-static StackNode *moveStackTo (int position, Stack *L) {
-	int i;
-	StackNode *p=L->first;
-	for(i=0;i<position;i++) p=p->next;
-	return p;
+int seekListCursor (ListCursor *C, int position) {
+	assert(position >= 0);
+	
+	if(position>=C->list->size) {
+		C->chunk=NULL;
+		return 0;
+	}
+	C->chunk=moveListTo(position,C->list,&C->index);
+	return 1;
 }
 
 
-void initializeStack (Stack *L) {
-	L->size=0;
-	L->first=NULL;
+int nextListCursor (ListCursor *C) {
+	if(C->chunk==NULL) return 0;
+	if(++C->index==C->chunk->count) {
+		C->chunk=C->chunk->next;
+		C->index=0;
+	}
+	return C->chunk!=NULL;
 }
 
 
-void pushStack (Item X, Stack *L) {
-    StackNode *q;
-	L->size++;
-	q=(StackNode *)malloc(sizeof(StackNode));
-    q->item = X;
-    q->next = L->first;
-    L->first = q;
+void peekListCursor (ListCursor *C, Item *X) {
+	assert(C->chunk != NULL);
+	
+	copyListItem(X,C->chunk->items[C->index]);
 }
 
 
-void popStack (Stack *L) {
-    assert(L != NULL);
-    StackNode *tempNode;
-    Item tempItem;
+void insertListCursor (ListCursor *C, Item X) {
+	ListChunk *c;
+	int offset;
+	
+	if(C->chunk==NULL) {
+		if(C->list->size==0) newListChunk(NULL,C->list);
+		c=C->list->first;
+		offset=0;
+		insertInChunk(X,&c,&offset,C->list);
+		return;
+	}
+	c=C->chunk;
+	offset=C->index+1;
+	insertInChunk(X,&c,&offset,C->list);
+	/* A split may have moved the Item at the cursor, which is the
+	 * one before the new Item. */
+	if(offset>0) {
+		C->chunk=c;
+		C->index=offset-1;
+	} else {
+		C->chunk=c->prev;
+		C->index=c->prev->count-1;
+	}
+}
 
-    topStack(L, &tempItem);
-    tempNode = L->first;
-    L->first = L->first->next;
-	free(tempNode);
-	L->size--;
+
+int removeListCursor (ListCursor *C) {
+	assert(C->chunk != NULL);
+	
+	deleteInChunk(&C->chunk,&C->index,C->list);
+	return C->chunk!=NULL;
 }
 
+///////////////////////////////////////////////////////////////////////
 
-int fullStack (Stack *L) {
-	return L->size;
+
+// Stack Implementation
+///////////////////////////////////////////////////////////////////////
+
+#define STACKMINIMUMCAPACITY 16
+
+static void copyStackItem (Item *Y, Item X) {
+	*Y=X;
+// Chenge to item ----------> InitializeItem(NameOfItem(X),Y);
 }
 
 
-int emptyStack (Stack *L) {
-	return L->size==0;
+static void destroyStackItem (Item *X) {
+// Chenge to item ----------> FreeItem(X);
 }
 
 
-int lengthStack (Stack *L) {
-	return L->size;
+/* Moves the items of a Stack to an array with room for capacity
+ * items. */
+static int resizeStack (Stack *S, int capacity) {
+	Item *items;
+	
+	assert(capacity >= S->size);
+	if(S->items==NULL) items=allocateMemory(S->allocator,sizeof(Item)*capacity);
+	else items=resizeMemory(S->allocator,S->items,sizeof(Item)*S->size,sizeof(Item)*capacity);
+	if(items==NULL) return 0;
+	S->items=items;
+	S->capacity=capacity;
+	return 1;
 }
 
 
-void topStack (Stack *L, Item *X) {
-    *X = L->first->item;
+void initializeStack (Stack *S) {
+	S->items=NULL;
+	S->size=0;
+	S->capacity=0;
+	S->bounded=0;
+	S->allocator=NULL;
 }
 
-void destroyStack (Stack *L) {
-	int i;
-	StackNode *p, *q;
+
+int initializeBoundedStack (Stack *S, int capacity) {
+	assert(capacity > 0);
+	initializeStack(S);
+	S->bounded=1;
+	return resizeStack(S,capacity);
+}
+
+
+int setAllocatorStack (Stack *S, Allocator *A) {
+	Item *items=NULL;
 	
-	p=L->first;
-	for(i=0;i<L->size;i++) {
-		q=p;
-		p=p->next;
-		destroyStackItem(&q->item);
-		free(q);
+	assert(emptyStack(S));
+	if(S->capacity>0) {
+		items=allocateMemory(A,sizeof(Item)*S->capacity);
+		if(items==NULL) return 0;
 	}
+	if(S->items!=NULL) releaseMemory(S->allocator,S->items);
+	S->items=items;
+	S->allocator=A;
+	return 1;
 }
 
-void reverseStack (Stack *L) {
-    assert(L != NULL);
-    
-    StackNode *head, *remainder;
-    Stack tempRest;
-    
-    head = L->first;
-    remainder = head->next;
-    if (remainder == NULL)
-        return;
-    tempRest.first = remainder;
-    
-    reverseStack(&tempRest);
-    
-    head->next->next = head;
-    head->next = NULL;    
-    L->first = tempRest.first;
+
+int reserveStack (Stack *S, int capacity) {
+	if(capacity<=S->capacity) return 1;
+	return resizeStack(S,capacity);
 }
 
-///////////////////////////////////////////////////////////////////////
 
+int pushStack (Item X, Stack *S) {
+	int capacity;
+	
+	if(S->size==S->capacity) {
+		if(S->bounded) return 0;
+		capacity=S->capacity<STACKMINIMUMCAPACITY ? STACKMINIMUMCAPACITY : 2*S->capacity;
+		if(!resizeStack(S,capacity)) return 0;
+	}
+	copyStackItem(&S->items[S->size],X);
+	S->size++;
+	return 1;
+}
 
-// BST Implementation
-///////////////////////////////////////////////////////////////////////
 
-static TreeNode *minimum (TreeNode *N) {
-	while(N->left!=NULL) N=N->left;
-	return N;
+void popStack (Stack *S) {
+	assert(!emptyStack(S));
+	S->size--;
 }
 
 
-static void destroy (TreeNode *N, Tree *T) {
-	if(N!=NULL) {
-		destroy(N->left,T);
-		destroy(N->right,T);
-		T->destroyItem(N->item);
-		free(N);
-	}
+int fullStack (Stack *S) {
+	return S->bounded && S->size==S->capacity;
 }
 
 
-void initializeBST (Tree *T,
-				 void * (*copyItem) (void *, void *),
-				 void (*destroyItem) (void *),
-				 int (*compareItems) (void *, void *)) {
-	T->root=NULL;
-	T->copyItem=copyItem;
-	T->destroyItem=destroyItem;
-	T->compareItems=compareItems;
+int emptyStack (Stack *S) {
+	return S->size==0;
 }
 
 
-void insertBST (Tree *T, void *I) {
-	TreeNode *N, *P, *Q;
-	
-	N=malloc(sizeof(TreeNode));
-	N->item=T->copyItem(NULL,I);
-	N->right=NULL;
-	N->left=NULL;
-	P=T->root;
-	Q=NULL;
-	
-	while(P!=NULL) {
-		Q=P;
-		if(T->compareItems(I,P->item)<0) P=P->left;
-		else P=P->right;
-	}
-	
-	N->parent=Q;
-	if(Q==NULL) T->root=N;
-	else if(T->compareItems(I,Q->item)<0) Q->left=N;
-	else Q->right=N;
+int lengthStack (Stack *S) {
+	return S->size;
 }
 
 
-int minimumBST (Tree *T, void *I) {
-	TreeNode *N;
-	if(T->root==NULL) return 0;
-	N=minimum(T->root);
-	T->current=N;
-	T->copyItem(I,N->item);
-	return 1;
+void topStack (Stack *S, Item *X) {
+	assert(!emptyStack(S));
+	*X=S->items[S->size-1];
 }
 
 
-int successorBST (Tree *T, void *I) {
-	TreeNode *N, *P;
-	if(T->root==NULL) return 0;
-	if((N=T->current->right)!=NULL) {
-		P=minimum(N);
-		T->current=P;
-		T->copyItem(I,P->item);
-		return 1;
-	}
-	N=T->current;
-	P=N->parent;
-	while(P!=NULL && N==P->right) {
-		N=P;
-		P=P->parent;
-	}
-	if(P==NULL) return 0;
-	T->current=P;
-	T->copyItem(I,P->item);
-	return 1;
+void destroyStack (Stack *S) {
+	int i;
+	
+	for(i=0;i<S->size;i++) destroyStackItem(&S->items[i]);
+	if(S->items!=NULL) releaseMemory(S->allocator,S->items);
 }
 
 
-void destroyBST (Tree *T) {
-	destroy(T->root,T);	
+void reverseStack (Stack *S) {
+	Item temp;
+	int i, j;
+	
+	for(i=0,j=S->size-1;i<j;i++,j--) {
+		temp=S->items[i];
+		S->items[i]=S->items[j];
+		S->items[j]=temp;
+	}
 }
 
 ///////////////////////////////////////////////////////////////////////
 
 
-// AVL Tree Implementation
+// Concurrent Stack Implementation
 ///////////////////////////////////////////////////////////////////////
 
-static TreeNode *insert (Tree *T, void *I) {
+/* The top and free list of a ConcurrentStack each pack the index of
+ * their first node (0 for none) in the low 32 bits and a tag in the
+ * high 32 bits. Every change of either one bumps its tag, so a
+ * compare-and-swap by a thread that read the first node before it
+ * was popped and pushed again fails instead of linking in a stale
+ * next index. Nodes are only freed by Destroy, so a thread may read
+ * one it lost the race for. */
+
+static uint64_t packConcurrentStack (uint32_t index, uint64_t old) {
+	return ((old>>32)+1)<<32|index;
+}
+
+
+static uint32_t popNode (ConcurrentStack *C, _Atomic uint64_t *head) {
+	uint64_t old;
+	uint32_t index, next;
+	
+	old=atomic_load_explicit(head,memory_order_acquire);
+	do {
+		index=(uint32_t)old;
+		if(index==0) return 0;
+		next=atomic_load_explicit(&C->nodes[index].next,memory_order_relaxed);
+	} while(!atomic_compare_exchange_weak_explicit(head,&old,packConcurrentStack(next,old),
+											memory_order_acquire,memory_order_acquire));
+	return index;
+}
+
+
+static void pushNode (ConcurrentStack *C, _Atomic uint64_t *head, uint32_t index) {
+	uint64_t old;
+	
+	old=atomic_load_explicit(head,memory_order_relaxed);
+	do {
+		atomic_store_explicit(&C->nodes[index].next,(uint32_t)old,memory_order_relaxed);
+	} while(!atomic_compare_exchange_weak_explicit(head,&old,packConcurrentStack(index,old),
+											memory_order_release,memory_order_relaxed));
+}
+
+
+int initializeConcurrentStack (ConcurrentStack *C, int capacity) {
+	int i;
+	
+	assert(capacity > 0);
+	C->nodes=malloc(sizeof(ConcurrentStackNode)*((size_t)capacity+1));
+	if(C->nodes==NULL) return 0;
+	for(i=1;i<=capacity;i++) atomic_init(&C->nodes[i].next,i<capacity ? i+1 : 0);
+	atomic_init(&C->top,0);
+	atomic_init(&C->free,1);
+	C->capacity=capacity;
+	return 1;
+}
+
+
+int pushConcurrentStack (Item X, ConcurrentStack *C) {
+	uint32_t index;
+	
+	index=popNode(C,&C->free);
+	if(index==0) return 0;
+	copyStackItem(&C->nodes[index].item,X);
+	pushNode(C,&C->top,index);
+	return 1;
+}
+
+
+int popConcurrentStack (ConcurrentStack *C, Item *X) {
+	uint32_t index;
+	
+	index=popNode(C,&C->top);
+	if(index==0) return 0;
+	*X=C->nodes[index].item;
+	pushNode(C,&C->free,index);
+	return 1;
+}
+
+
+int emptyConcurrentStack (ConcurrentStack *C) {
+	return (uint32_t)atomic_load_explicit(&C->top,memory_order_acquire)==0;
+}
+
+
+void destroyConcurrentStack (ConcurrentStack *C) {
+	uint32_t index;
+	
+	index=(uint32_t)atomic_load(&C->top);
+	while(index!=0) {
+		destroyStackItem(&C->nodes[index].item);
+		index=atomic_load(&C->nodes[index].next);
+	}
+	free(C->nodes);
+}
+
+///////////////////////////////////////////////////////////////////////
+
+
+// BST Implementation
+///////////////////////////////////////////////////////////////////////
+
+static TreeNode *minimum (TreeNode *N) {
+	while(N->left!=NULL) N=N->left;
+	return N;
+}
+
+
+static TreeNode *maximum (TreeNode *N) {
+	while(N->right!=NULL) N=N->right;
+	return N;
+}
+
+
+static TreeNode *successor (TreeNode *N) {
+	TreeNode *P;
+	if(N->right!=NULL) return minimum(N->right);
+	P=N->parent;
+	while(P!=NULL && N==P->right) {
+		N=P;
+		P=P->parent;
+	}
+	return P;
+}
+
+
+static TreeNode *predecessor (TreeNode *N) {
+	TreeNode *P;
+	if(N->left!=NULL) return maximum(N->left);
+	P=N->parent;
+	while(P!=NULL && N==P->left) {
+		N=P;
+		P=P->parent;
+	}
+	return P;
+}
+
+
+static int size (TreeNode *N) {
+	if(N==NULL) return 0;
+	return N->size;
+}
+
+
+/* Inline items are stored right after their node, at an offset
+ * that keeps them aligned. */
+#define INLINEOFFSET ((sizeof(TreeNode)+POOLALIGNMENT-1)/POOLALIGNMENT*POOLALIGNMENT)
+
+static TreeNode *newNode (Tree *T, void *I) {
+	TreeNode *N;
+	
+	COUNTSTATISTIC(T,allocations);
+	if(T->itemSize==0) {
+		N=allocateMemory(T->allocator,sizeof(TreeNode));
+		N->item=T->copyItem(NULL,I);
+	}
+	else {
+		N=allocateMemory(T->allocator,INLINEOFFSET+T->itemSize);
+		N->item=(char *)N+INLINEOFFSET;
+		memcpy(N->item,I,T->itemSize);
+	}
+	return N;
+}
+
+
+static void freeNode (Tree *T, TreeNode *N) {
+	COUNTSTATISTIC(T,frees);
+	if(T->itemSize==0) T->destroyItem(N->item);
+	releaseMemory(T->allocator,N);
+}
+
+
+static void copyOut (Tree *T, void *I, TreeNode *N) {
+	if(T->itemSize==0) T->copyItem(I,N->item);
+	else memcpy(I,N->item,T->itemSize);
+}
+
+
+static void destroy (TreeNode *N, Tree *T) {
+	if(N!=NULL) {
+		destroy(N->left,T);
+		destroy(N->right,T);
+		if(T->itemSize==0) T->destroyItem(N->item);
+		if(!releasesAll(T->allocator)) releaseMemory(T->allocator,N);
+		COUNTSTATISTIC(T,frees);
+	}
+}
+
+
+/* Destroys every node, unless the items need no destroying and the
+ * Allocator can hand back all of its pages at once, which still
+ * counts as freeing every node. */
+static void destroyTree (Tree *T) {
+	if(T->itemSize==0 || !releasesAll(T->allocator)) destroy(T->root,T);
+	else ADDSTATISTIC(T,frees,T->size);
+	if(releasesAll(T->allocator)) T->allocator->releaseAll(T->allocator->context);
+}
+
+
+/* Compares two items of a Tree, counting the comparison. */
+static int compareTree (Tree *T, void *I, void *J) {
+	COUNTSTATISTIC(T,comparisons);
+	return T->compareItems(I,J);
+}
+
+
+static TreeNode *search (Tree *T, void *I) {
+	TreeNode *N;
+	int c;
+	
+	N=T->root;
+	while(N!=NULL) {
+		c=T->compareItems(I,N->item);
+		if(c==0) return N;
+		if(c<0) N=N->left;
+		else N=N->right;
+	}
+	return NULL;
+}
+
+
+/* Search for Search and Delete, which count what they do. Cursors, Rank
+   and RangeVisit use search, which leaves the Tree untouched. */
+static TreeNode *countedSearch (Tree *T, void *I) {
+	TreeNode *N;
+	int c, depth=0;
+	
+	N=T->root;
+	while(N!=NULL) {
+		c=compareTree(T,I,N->item);
+		if(c==0) break;
+		if(c<0) N=N->left;
+		else N=N->right;
+		depth++;
+	}
+	DEPTHSTATISTIC(T,depth);
+	return N;
+}
+
+
+static TreeNode *kth (Tree *T, int k) {
+	TreeNode *N;
+	
+	if(k<0 || k>=size(T->root)) return NULL;
+	N=T->root;
+	while(k!=size(N->left)) {
+		if(k<size(N->left)) N=N->left;
+		else {
+			k-=size(N->left)+1;
+			N=N->right;
+		}
+	}
+	return N;
+}
+
+
+static int rank (Tree *T, void *I) {
+	TreeNode *N;
+	int r=0;
+	
+	N=T->root;
+	while(N!=NULL) {
+		if(T->compareItems(I,N->item)<=0) N=N->left;
+		else {
+			r+=size(N->left)+1;
+			N=N->right;
+		}
+	}
+	return r;
+}
+
+
+/* Finds the least item not less than I, or, if strict is nonzero,
+ * the least item greater than I. */
+static TreeNode *bound (Tree *T, void *I, int strict) {
+	TreeNode *N, *B;
+	int c;
+	
+	N=T->root;
+	B=NULL;
+	while(N!=NULL) {
+		c=T->compareItems(I,N->item);
+		if(c<0 || (c==0 && !strict)) {
+			B=N;
+			N=N->left;
+		}
+		else N=N->right;
+	}
+	return B;
+}
+
+
+static int rangeVisit (Tree *T, void *lo, void *hi,
+				int (*visit) (void *, void *), void *context) {
+	TreeNode *N;
+	int n=0;
+	
+	for(N=bound(T,lo,0);N!=NULL;N=successor(N)) {
+		if(T->compareItems(N->item,hi)>0) break;
+		n++;
+		if(!visit(N->item,context)) break;
+	}
+	return n;
+}
+
+
+/* Builds a perfectly balanced subtree out of n sorted items. */
+static TreeNode *build (Tree *T, void **items, int n, TreeNode *P) {
+	TreeNode *N;
+	int mid;
+	
+	if(n==0) return NULL;
+	mid=n/2;
+	N=newNode(T,items[mid]);
+	N->parent=P;
+	N->left=build(T,items,mid,N);
+	N->right=build(T,items+mid+1,n-mid-1,N);
+	N->size=n;
+	if(N->left!=NULL) N->height=1+N->left->height;
+	else N->height=0;
+	return N;
+}
+
+
+/* Puts the subtree rooted at M where the subtree rooted at N was. */
+static void transplant (Tree *T, TreeNode *N, TreeNode *M) {
+	if(N->parent==NULL) T->root=M;
+	else if(N->parent->left==N) N->parent->left=M;
+	else N->parent->right=M;
+	if(M!=NULL) M->parent=N->parent;
+}
+
+
+/* Unlinks N from the Tree without freeing it, and returns the lowest
+ * node whose subtree has lost a node (NULL if there is none). */
+static TreeNode *removeNode (Tree *T, TreeNode *N) {
+	TreeNode *S, *P, *Q;
+	
+	if(N->left==NULL) {
+		P=N->parent;
+		transplant(T,N,N->right);
+	}
+	else if(N->right==NULL) {
+		P=N->parent;
+		transplant(T,N,N->left);
+	}
+	else {
+		S=minimum(N->right);
+		if(S->parent==N) P=S;
+		else {
+			P=S->parent;
+			transplant(T,S,S->right);
+			S->right=N->right;
+			S->right->parent=S;
+		}
+		transplant(T,N,S);
+		S->left=N->left;
+		S->left->parent=S;
+		S->height=N->height;
+		S->size=N->size;
+	}
+	for(Q=P;Q!=NULL;Q=Q->parent) Q->size--;
+	return P;
+}
+
+
+void initializeBST (Tree *T,
+				 void * (*copyItem) (void *, void *),
+				 void (*destroyItem) (void *),
+				 int (*compareItems) (void *, void *)) {
+	T->root=NULL;
+	T->copyItem=copyItem;
+	T->destroyItem=destroyItem;
+	T->compareItems=compareItems;
+	T->size=0;
+	T->itemSize=0;
+	T->allocator=NULL;
+	CLEARSTATISTICS(T);
+}
+
+
+void initializeInlineBST (Tree *T,
+				 size_t itemSize,
+				 int (*compareItems) (void *, void *)) {
+	assert(itemSize > 0);
+	initializeBST(T,NULL,NULL,compareItems);
+	T->itemSize=itemSize;
+}
+
+
+void setAllocatorBST (Tree *T, Allocator *A) {
+	assert(T->root==NULL);
+	T->allocator=A;
+}
+
+
+void insertBST (Tree *T, void *I) {
+	TreeNode *N, *P, *Q;
+	int c=0, depth=0;
+	
+	N=newNode(T,I);
+	N->right=NULL;
+	N->left=NULL;
+	N->height=0;
+	N->size=1;
+	P=T->root;
+	Q=NULL;
+	
+	while(P!=NULL) {
+		Q=P;
+		P->size++;
+		c=compareTree(T,I,P->item);
+		if(c<0) P=P->left;
+		else P=P->right;
+		depth++;
+	}
+	DEPTHSTATISTIC(T,depth);
+	
+	N->parent=Q;
+	if(Q==NULL) T->root=N;
+	else if(c<0) Q->left=N;
+	else Q->right=N;
+	T->size++;
+}
+
+
+int minimumBST (Tree *T, void *I) {
+	TreeNode *N;
+	if(T->root==NULL) return 0;
+	N=minimum(T->root);
+	T->current=N;
+	copyOut(T,I,N);
+	return 1;
+}
+
+
+int successorBST (Tree *T, void *I) {
+	TreeNode *P;
+	if(T->root==NULL) return 0;
+	if((P=successor(T->current))==NULL) return 0;
+	T->current=P;
+	copyOut(T,I,P);
+	return 1;
+}
+
+
+void buildBST (Tree *T, void **items, int n) {
+	assert(T->root==NULL);
+	T->root=build(T,items,n,NULL);
+	T->size=n;
+}
+
+
+int searchBST (Tree *T, void *I, void *J) {
+	TreeNode *N;
+	if((N=countedSearch(T,I))==NULL) return 0;
+	T->current=N;
+	if(J!=NULL) copyOut(T,J,N);
+	return 1;
+}
+
+
+int rangeVisitBST (Tree *T, void *lo, void *hi,
+				int (*visit) (void *, void *), void *context) {
+	return rangeVisit(T,lo,hi,visit,context);
+}
+
+
+int selectBST (Tree *T, int k, void *I) {
+	TreeNode *N;
+	if((N=kth(T,k))==NULL) return 0;
+	T->current=N;
+	copyOut(T,I,N);
+	return 1;
+}
+
+
+int rankBST (Tree *T, void *I) {
+	return rank(T,I);
+}
+
+
+int deleteBST (Tree *T, void *I) {
+	TreeNode *N;
+	if((N=countedSearch(T,I))==NULL) return 0;
+	removeNode(T,N);
+	freeNode(T,N);
+	T->size--;
+	return 1;
+}
+
+
+Statistics statsBST (Tree *T) {
+	return STATISTICS(T);
+}
+
+
+void destroyBST (Tree *T) {
+	destroyTree(T);
+}
+
+///////////////////////////////////////////////////////////////////////
+
+
+// AVL Tree Implementation
+///////////////////////////////////////////////////////////////////////
+
+static TreeNode *insert (Tree *T, void *I) {
 	TreeNode *N, *P, *Q;
+	int c=0, depth=0;
 	
-	N=malloc(sizeof(TreeNode));
-	N->item=T->copyItem(NULL,I);
+	N=newNode(T,I);
 	N->right=NULL;
 	N->left=NULL;
+	N->height=0;
+	N->size=1;
 	P=T->root;
 	Q=NULL;
 	
-	while(P!=NULL) {
-		Q=P;
-		if(T->compareItems(I,P->item)<0) P=P->left;
-		else P=P->right;
+	while(P!=NULL) {
+		Q=P;
+		P->size++;
+		c=compareTree(T,I,P->item);
+		if(c<0) P=P->left;
+		else P=P->right;
+		depth++;
+	}
+	DEPTHSTATISTIC(T,depth);
+	
+	N->parent=Q;
+	if(Q==NULL) T->root=N;
+	else if(c<0) Q->left=N;
+	else Q->right=N;
+	T->size++;
+	return N;
+}
+
+
+static int height (TreeNode *N) {
+	if(N==NULL) return -1;
+	return N->height;
+}
+
+
+static int balance (TreeNode *N) {
+	return height(N->left)-height(N->right);
+}
+
+
+static void updateHeight (TreeNode *N) {
+	int hleft, hright;
+	hleft=height(N->left);
+	hright=height(N->right);
+	if(hleft<hright) N->height=1+hright;
+	else N->height=1+hleft;
+}
+
+
+static void updateSize (TreeNode *N) {
+	N->size=1+size(N->left)+size(N->right);
+}
+
+
+/* Rotates the unbalanced node C with its taller child B and B's taller
+ * child A (the one on B's own side when both are as tall), and returns
+ * the root of the restructured subtree. */
+static TreeNode *restructure (Tree *T, TreeNode *C) {
+	TreeNode *N, *A, *B, *P;
+	TreeNode *T1, *T2, *T3, *T4;
+	int i;
+	
+	if(balance(C)>0) {
+		B=C->left;
+		A=balance(B)<0 ? B->right : B->left;
+	}
+	else {
+		B=C->right;
+		A=balance(B)>0 ? B->left : B->right;
+	}
+	P=C->parent;
+	if(P==NULL) i=0;
+	else if(P->left==C) i=-1;
+	else i=1;
+	
+	if(C->left==B) 
+		if(B->left==A) {
+			COUNTSTATISTIC(T,leftLeftRotations);
+			T2=A->right; T3=B->right; 
+		}
+		else {
+			COUNTSTATISTIC(T,leftRightRotations);
+			N=A; A=B; B=N;
+			T2=B->left; T3=B->right; 
+		}
+	else 
+		if(B->left==A) {
+			COUNTSTATISTIC(T,rightLeftRotations);
+			N=A; A=C; C=B; B=N;
+			T2=B->left; T3=B->right; 
+		}
+		else {
+			COUNTSTATISTIC(T,rightRightRotations);
+			N=A; A=C; C=N;
+			T2=B->left; T3=C->left;
+		}	
+	
+	T1=A->left; T4=C->right;
+	A->right=T2; C->left=T3;
+	B->left=A; B->right=C; 
+	A->parent=B; C->parent=B;
+	if(T1!=NULL) T1->parent=A; 
+	if(T2!=NULL) T2->parent=A;
+	if(T3!=NULL) T3->parent=C;
+ 	if(T4!=NULL) T4->parent=C;
+	if(i==0) {T->root=B; B->parent=NULL;}
+	else if(i==-1) {P->left=B; B->parent=P;}
+	else {P->right=B; B->parent=P;}
+	
+	updateHeight(A); updateSize(A);
+	updateHeight(C); updateSize(C);
+	updateHeight(B); updateSize(B);
+	return B;
+}
+
+
+void initializeAVL (Tree *T,
+				 void * (*copyItem) (void *, void *),
+				 void (*destroyItem) (void *),
+				 int (*compareItems) (void *, void *)) {
+	T->root=NULL;
+	T->copyItem=copyItem;
+	T->destroyItem=destroyItem;
+	T->compareItems=compareItems;
+	T->size=0;
+	T->itemSize=0;
+	T->allocator=NULL;
+	CLEARSTATISTICS(T);
+}
+
+
+void initializeInlineAVL (Tree *T,
+				 size_t itemSize,
+				 int (*compareItems) (void *, void *)) {
+	assert(itemSize > 0);
+	initializeAVL(T,NULL,NULL,compareItems);
+	T->itemSize=itemSize;
+}
+
+
+void setAllocatorAVL (Tree *T, Allocator *A) {
+	assert(T->root==NULL);
+	T->allocator=A;
+}
+
+
+void insertAVL (Tree *T, void *I) {
+	TreeNode *N;
+	int oldHeight;
+	
+	N=insert(T,I);
+	for(N=N->parent;N!=NULL;N=N->parent) {
+		oldHeight=N->height;
+		if(balance(N)<-1 || balance(N)>1) {
+			restructure(T,N);
+			return;
+		}
+		updateHeight(N);
+		if(N->height==oldHeight) return;
+	}
+}
+
+
+void buildAVL (Tree *T, void **items, int n) {
+	assert(T->root==NULL);
+	T->root=build(T,items,n,NULL);
+	T->size=n;
+}
+
+
+int minimumAVL (Tree *T, void *I) {
+	TreeNode *N;
+	if(T->root==NULL) return 0;
+	N=minimum(T->root);
+	T->current=N;
+	copyOut(T,I,N);
+	return 1;
+}
+
+
+int successorAVL (Tree *T, void *I) {
+	TreeNode *P;
+	if(T->root==NULL) return 0;
+	if((P=successor(T->current))==NULL) return 0;
+	T->current=P;
+	copyOut(T,I,P);
+	return 1;
+}
+
+
+int searchAVL (Tree *T, void *I, void *J) {
+	TreeNode *N;
+	if((N=countedSearch(T,I))==NULL) return 0;
+	T->current=N;
+	if(J!=NULL) copyOut(T,J,N);
+	return 1;
+}
+
+
+int rangeVisitAVL (Tree *T, void *lo, void *hi,
+				int (*visit) (void *, void *), void *context) {
+	return rangeVisit(T,lo,hi,visit,context);
+}
+
+
+int selectAVL (Tree *T, int k, void *I) {
+	TreeNode *N;
+	if((N=kth(T,k))==NULL) return 0;
+	T->current=N;
+	copyOut(T,I,N);
+	return 1;
+}
+
+
+int rankAVL (Tree *T, void *I) {
+	return rank(T,I);
+}
+
+
+int deleteAVL (Tree *T, void *I) {
+	TreeNode *N, *P;
+	int oldHeight;
+	
+	if((N=countedSearch(T,I))==NULL) return 0;
+	P=removeNode(T,N);
+	freeNode(T,N);
+	T->size--;
+	
+	while(P!=NULL) {
+		oldHeight=P->height;
+		if(balance(P)<-1 || balance(P)>1) P=restructure(T,P);
+		else updateHeight(P);
+		if(P->height==oldHeight) break;
+		P=P->parent;
+	}
+	return 1;
+}
+
+
+int sizeAVL (Tree *T) {
+	return T->size;
+}
+
+
+int heightAVL (Tree *T) {
+	return height(T->root);
+}
+
+
+int balancedAVL (Tree *T) {
+	if(T->root==NULL) return 1;
+	if(balance(T->root)<-1 || balance(T->root)>1) return 0;
+	return 1;
+}
+
+
+Statistics statsAVL (Tree *T) {
+	return STATISTICS(T);
+}
+
+
+void destroyAVL (Tree *T) {
+	destroyTree(T);
+}
+
+///////////////////////////////////////////////////////////////////////
+
+
+// Tree Cursor Implementation
+///////////////////////////////////////////////////////////////////////
+
+void initializeTreeCursor (TreeCursor *C, Tree *T) {
+	C->tree=T;
+	C->node=NULL;
+}
+
+
+int firstTreeCursor (TreeCursor *C) {
+	if(C->tree->root==NULL) C->node=NULL;
+	else C->node=minimum(C->tree->root);
+	return C->node!=NULL;
+}
+
+
+int lastTreeCursor (TreeCursor *C) {
+	if(C->tree->root==NULL) C->node=NULL;
+	else C->node=maximum(C->tree->root);
+	return C->node!=NULL;
+}
+
+
+int seekTreeCursor (TreeCursor *C, void *I) {
+	C->node=search(C->tree,I);
+	return C->node!=NULL;
+}
+
+
+int lowerBoundTreeCursor (TreeCursor *C, void *I) {
+	C->node=bound(C->tree,I,0);
+	return C->node!=NULL;
+}
+
+
+int upperBoundTreeCursor (TreeCursor *C, void *I) {
+	C->node=bound(C->tree,I,1);
+	return C->node!=NULL;
+}
+
+
+int nextTreeCursor (TreeCursor *C) {
+	if(C->node==NULL) return 0;
+	C->node=successor(C->node);
+	return C->node!=NULL;
+}
+
+
+int prevTreeCursor (TreeCursor *C) {
+	if(C->node==NULL) return 0;
+	C->node=predecessor(C->node);
+	return C->node!=NULL;
+}
+
+
+void *currentTreeCursor (TreeCursor *C) {
+	if(C->node==NULL) return NULL;
+	return C->node->item;
+}
+
+///////////////////////////////////////////////////////////////////////
+
+
+// B-Tree Implementation
+///////////////////////////////////////////////////////////////////////
+
+#define BTREEMINIMUM (BTREEORDER/2)
+#define BTREEMAXITEMS (BTREEORDER-1)
+#define BTREEHEADER ((sizeof(BTreeNode)+POOLALIGNMENT-1)/POOLALIGNMENT*POOLALIGNMENT)
+
+static char *slotBTree (BTree *T, BTreeNode *N, int i) {
+	return (char *)N+BTREEHEADER+(size_t)i*T->slotSize;
+}
+
+
+static BTreeNode **childrenBTree (BTree *T, BTreeNode *N) {
+	return (BTreeNode **)((char *)N+T->childrenOffset);
+}
+
+
+static void *itemBTree (BTree *T, char *S) {
+	if(T->itemSize==0) return *(void **)S;
+	return S;
+}
+
+
+static void moveSlots (BTree *T, BTreeNode *D, int d, BTreeNode *S, int s, int n) {
+	memmove(slotBTree(T,D,d),slotBTree(T,S,s),(size_t)n*T->slotSize);
+}
+
+
+static void moveChildren (BTree *T, BTreeNode *D, int d, BTreeNode *S, int s, int n) {
+	memmove(childrenBTree(T,D)+d,childrenBTree(T,S)+s,(size_t)n*sizeof(BTreeNode *));
+}
+
+
+static BTreeNode *newBTreeNode (BTree *T, int leaf) {
+	BTreeNode *N;
+	
+	if(T->allocator==NULL) N=aligned_alloc(CACHELINE,T->nodeSize);
+	else N=allocateMemory(T->allocator,T->nodeSize);
+	N->numberOfItems=0;
+	N->leaf=leaf;
+	return N;
+}
+
+
+static void storeBTree (BTree *T, char *S, void *I) {
+	if(T->itemSize==0) *(void **)S=T->copyItem(NULL,I);
+	else memcpy(S,I,T->itemSize);
+}
+
+
+static void copyOutBTree (BTree *T, void *I, char *S) {
+	if(T->itemSize==0) T->copyItem(I,*(void **)S);
+	else memcpy(I,S,T->itemSize);
+}
+
+
+static void destroySlot (BTree *T, char *S) {
+	if(T->itemSize==0) T->destroyItem(*(void **)S);
+}
+
+
+/* Finds the first item of N not less than I, or, if strict is
+ * nonzero, the first item greater than I. */
+static int boundBTree (BTree *T, BTreeNode *N, void *I, int strict) {
+	int lo, hi, mid, c;
+	
+	lo=0;
+	hi=N->numberOfItems;
+	while(lo<hi) {
+		mid=(lo+hi)/2;
+		c=T->compareItems(I,itemBTree(T,slotBTree(T,N,mid)));
+		if(c>0 || (c==0 && strict)) lo=mid+1;
+		else hi=mid;
+	}
+	return lo;
+}
+
+
+/* Splits the full i-th child of X around its middle item,
+ * which moves up into X. */
+static void splitChild (BTree *T, BTreeNode *X, int i) {
+	BTreeNode *Y, *Z;
+	
+	Y=childrenBTree(T,X)[i];
+	Z=newBTreeNode(T,Y->leaf);
+	Z->numberOfItems=BTREEMINIMUM-1;
+	moveSlots(T,Z,0,Y,BTREEMINIMUM,BTREEMINIMUM-1);
+	if(!Y->leaf) moveChildren(T,Z,0,Y,BTREEMINIMUM,BTREEMINIMUM);
+	Y->numberOfItems=BTREEMINIMUM-1;
+	
+	moveChildren(T,X,i+2,X,i+1,X->numberOfItems-i);
+	childrenBTree(T,X)[i+1]=Z;
+	moveSlots(T,X,i+1,X,i,X->numberOfItems-i);
+	moveSlots(T,X,i,Y,BTREEMINIMUM-1,1);
+	X->numberOfItems++;
+}
+
+
+/* Merges the i-th and (i+1)-th children of X around the i-th item
+ * of X. */
+static void merge (BTree *T, BTreeNode *X, int i) {
+	BTreeNode *C, *R;
+	
+	C=childrenBTree(T,X)[i];
+	R=childrenBTree(T,X)[i+1];
+	moveSlots(T,C,C->numberOfItems,X,i,1);
+	moveSlots(T,C,C->numberOfItems+1,R,0,R->numberOfItems);
+	if(!C->leaf) moveChildren(T,C,C->numberOfItems+1,R,0,R->numberOfItems+1);
+	C->numberOfItems+=R->numberOfItems+1;
+	
+	moveSlots(T,X,i,X,i+1,X->numberOfItems-i-1);
+	moveChildren(T,X,i+1,X,i+2,X->numberOfItems-i-1);
+	X->numberOfItems--;
+	releaseMemory(T->allocator,R);
+}
+
+
+/* Makes sure the i-th child of X has more than the minimum number of
+ * items, by borrowing from a sibling or merging with one, and
+ * returns the index of the child that must be descended into. */
+static int fill (BTree *T, BTreeNode *X, int i) {
+	BTreeNode *C, *S;
+	
+	C=childrenBTree(T,X)[i];
+	if(C->numberOfItems>=BTREEMINIMUM) return i;
+	if(i>0 && (S=childrenBTree(T,X)[i-1])->numberOfItems>=BTREEMINIMUM) {
+		moveSlots(T,C,1,C,0,C->numberOfItems);
+		if(!C->leaf) moveChildren(T,C,1,C,0,C->numberOfItems+1);
+		moveSlots(T,C,0,X,i-1,1);
+		if(!C->leaf) childrenBTree(T,C)[0]=childrenBTree(T,S)[S->numberOfItems];
+		moveSlots(T,X,i-1,S,S->numberOfItems-1,1);
+		C->numberOfItems++;
+		S->numberOfItems--;
+	}
+	else if(i<X->numberOfItems && (S=childrenBTree(T,X)[i+1])->numberOfItems>=BTREEMINIMUM) {
+		moveSlots(T,C,C->numberOfItems,X,i,1);
+		if(!C->leaf) childrenBTree(T,C)[C->numberOfItems+1]=childrenBTree(T,S)[0];
+		moveSlots(T,X,i,S,0,1);
+		moveSlots(T,S,0,S,1,S->numberOfItems-1);
+		if(!S->leaf) moveChildren(T,S,0,S,1,S->numberOfItems);
+		C->numberOfItems++;
+		S->numberOfItems--;
+	}
+	else if(i<X->numberOfItems) merge(T,X,i);
+	else merge(T,X,--i);
+	return i;
+}
+
+
+/* Moves the greatest (or, if first is nonzero, the least) item of the
+ * subtree rooted at N into the slot S. */
+static void removeExtreme (BTree *T, BTreeNode *N, char *S, int first) {
+	int i;
+	
+	while(!N->leaf) {
+		i=fill(T,N,first ? 0 : N->numberOfItems);
+		N=childrenBTree(T,N)[i];
+	}
+	if(first) {
+		memcpy(S,slotBTree(T,N,0),T->slotSize);
+		moveSlots(T,N,0,N,1,N->numberOfItems-1);
+	}
+	else memcpy(S,slotBTree(T,N,N->numberOfItems-1),T->slotSize);
+	N->numberOfItems--;
+}
+
+
+static void destroyBTreeNode (BTree *T, BTreeNode *N) {
+	int i;
+	
+	for(i=0;i<N->numberOfItems;i++) destroySlot(T,slotBTree(T,N,i));
+	if(!N->leaf)
+		for(i=0;i<=N->numberOfItems;i++) destroyBTreeNode(T,childrenBTree(T,N)[i]);
+	if(!releasesAll(T->allocator)) releaseMemory(T->allocator,N);
+}
+
+
+void initializeBTree (BTree *T,
+				 void * (*copyItem) (void *, void *),
+				 void (*destroyItem) (void *),
+				 int (*compareItems) (void *, void *)) {
+	T->root=NULL;
+	T->size=0;
+	T->itemSize=0;
+	T->slotSize=sizeof(void *);
+	T->childrenOffset=(BTREEHEADER+BTREEMAXITEMS*T->slotSize+sizeof(void *)-1)/sizeof(void *)*sizeof(void *);
+	T->nodeSize=(T->childrenOffset+BTREEORDER*sizeof(BTreeNode *)+CACHELINE-1)/CACHELINE*CACHELINE;
+	T->allocator=NULL;
+	T->copyItem=copyItem;
+	T->destroyItem=destroyItem;
+	T->compareItems=compareItems;
+}
+
+
+void initializeInlineBTree (BTree *T,
+				 size_t itemSize,
+				 int (*compareItems) (void *, void *)) {
+	assert(itemSize > 0);
+	initializeBTree(T,NULL,NULL,compareItems);
+	T->itemSize=itemSize;
+	T->slotSize=itemSize;
+	T->childrenOffset=(BTREEHEADER+BTREEMAXITEMS*T->slotSize+sizeof(void *)-1)/sizeof(void *)*sizeof(void *);
+	T->nodeSize=(T->childrenOffset+BTREEORDER*sizeof(BTreeNode *)+CACHELINE-1)/CACHELINE*CACHELINE;
+}
+
+
+void setAllocatorBTree (BTree *T, Allocator *A) {
+	assert(T->root==NULL);
+	T->allocator=A;
+}
+
+
+void insertBTree (BTree *T, void *I) {
+	BTreeNode *N, *R;
+	int i;
+	
+	if(T->root==NULL) T->root=newBTreeNode(T,1);
+	if(T->root->numberOfItems==BTREEMAXITEMS) {
+		R=newBTreeNode(T,0);
+		childrenBTree(T,R)[0]=T->root;
+		T->root=R;
+		splitChild(T,R,0);
+	}
+	N=T->root;
+	while(!N->leaf) {
+		i=boundBTree(T,N,I,1);
+		if(childrenBTree(T,N)[i]->numberOfItems==BTREEMAXITEMS) {
+			splitChild(T,N,i);
+			if(T->compareItems(I,itemBTree(T,slotBTree(T,N,i)))>=0) i++;
+		}
+		N=childrenBTree(T,N)[i];
+	}
+	i=boundBTree(T,N,I,1);
+	moveSlots(T,N,i+1,N,i,N->numberOfItems-i);
+	storeBTree(T,slotBTree(T,N,i),I);
+	N->numberOfItems++;
+	T->size++;
+}
+
+
+int searchBTree (BTree *T, void *I, void *J) {
+	BTreeNode *N;
+	int i;
+	
+	N=T->root;
+	while(N!=NULL) {
+		i=boundBTree(T,N,I,0);
+		if(i<N->numberOfItems && T->compareItems(I,itemBTree(T,slotBTree(T,N,i)))==0) {
+			if(J!=NULL) copyOutBTree(T,J,slotBTree(T,N,i));
+			return 1;
+		}
+		if(N->leaf) return 0;
+		N=childrenBTree(T,N)[i];
+	}
+	return 0;
+}
+
+
+int deleteBTree (BTree *T, void *I) {
+	BTreeNode *N, *R;
+	int i, found=0;
+	
+	if((N=T->root)==NULL) return 0;
+	while(1) {
+		i=boundBTree(T,N,I,0);
+		if(i<N->numberOfItems && T->compareItems(I,itemBTree(T,slotBTree(T,N,i)))==0) {
+			if(N->leaf) {
+				destroySlot(T,slotBTree(T,N,i));
+				moveSlots(T,N,i,N,i+1,N->numberOfItems-i-1);
+				N->numberOfItems--;
+			}
+			else if(childrenBTree(T,N)[i]->numberOfItems>=BTREEMINIMUM) {
+				destroySlot(T,slotBTree(T,N,i));
+				removeExtreme(T,childrenBTree(T,N)[i],slotBTree(T,N,i),0);
+			}
+			else if(childrenBTree(T,N)[i+1]->numberOfItems>=BTREEMINIMUM) {
+				destroySlot(T,slotBTree(T,N,i));
+				removeExtreme(T,childrenBTree(T,N)[i+1],slotBTree(T,N,i),1);
+			}
+			else {
+				merge(T,N,i);
+				N=childrenBTree(T,N)[i];
+				continue;
+			}
+			found=1;
+			break;
+		}
+		if(N->leaf) break;
+		i=fill(T,N,i);
+		N=childrenBTree(T,N)[i];
+	}
+	
+	R=T->root;
+	if(R->numberOfItems==0) {
+		if(R->leaf) T->root=NULL;
+		else T->root=childrenBTree(T,R)[0];
+		releaseMemory(T->allocator,R);
+	}
+	if(found) T->size--;
+	return found;
+}
+
+
+int sizeBTree (BTree *T) {
+	return T->size;
+}
+
+
+void destroyBTree (BTree *T) {
+	if(T->root!=NULL && (T->itemSize==0 || !releasesAll(T->allocator)))
+		destroyBTreeNode(T,T->root);
+	if(releasesAll(T->allocator)) T->allocator->releaseAll(T->allocator->context);
+}
+
+
+/* Pops the levels of a BTreeCursor whose items have all been
+ * visited. */
+static int settle (BTreeCursor *C) {
+	while(C->depth>0 && C->indexes[C->depth-1]>=C->nodes[C->depth-1]->numberOfItems)
+		C->depth--;
+	return C->depth>0;
+}
+
+
+static void descend (BTreeCursor *C, BTreeNode *N) {
+	while(1) {
+		C->nodes[C->depth]=N;
+		C->indexes[C->depth]=0;
+		C->depth++;
+		if(N->leaf) return;
+		N=childrenBTree(C->tree,N)[0];
+	}
+}
+
+
+void initializeBTreeCursor (BTreeCursor *C, BTree *T) {
+	C->tree=T;
+	C->depth=0;
+}
+
+
+int firstBTreeCursor (BTreeCursor *C) {
+	C->depth=0;
+	if(C->tree->root==NULL) return 0;
+	descend(C,C->tree->root);
+	return settle(C);
+}
+
+
+int lowerBoundBTreeCursor (BTreeCursor *C, void *I) {
+	BTreeNode *N;
+	int i;
+	
+	C->depth=0;
+	N=C->tree->root;
+	while(N!=NULL) {
+		i=boundBTree(C->tree,N,I,0);
+		C->nodes[C->depth]=N;
+		C->indexes[C->depth]=i;
+		C->depth++;
+		if(N->leaf) break;
+		N=childrenBTree(C->tree,N)[i];
+	}
+	return settle(C);
+}
+
+
+int nextBTreeCursor (BTreeCursor *C) {
+	BTreeNode *N;
+	int i;
+	
+	if(C->depth==0) return 0;
+	N=C->nodes[C->depth-1];
+	i=++C->indexes[C->depth-1];
+	if(!N->leaf) descend(C,childrenBTree(C->tree,N)[i]);
+	return settle(C);
+}
+
+
+void *currentBTreeCursor (BTreeCursor *C) {
+	if(C->depth==0) return NULL;
+	return itemBTree(C->tree,slotBTree(C->tree,C->nodes[C->depth-1],C->indexes[C->depth-1]));
+}
+
+///////////////////////////////////////////////////////////////////////
+
+
+// Heap Implementation
+///////////////////////////////////////////////////////////////////////
+
+#define FIRSTCHILD(H,parent) ((H)->arity*((parent)-1)+2)
+#define PARENT(H,child) (((child)-2)/(H)->arity+1)
+
+/* Without an Allocator, the array of a Heap starts far enough into
+ * a cache-aligned block that slot 2, the first child of the root,
+ * begins a cache line. The children of node p start arity*(p-1)
+ * slots after it, so they share one line when arity*slotSize
+ * divides CACHELINE, and fill it when the two are equal. */
+static size_t heapOffset (Heap *H, Allocator *A) {
+	if(A!=NULL) return 0;
+	return (CACHELINE-2*H->slotSize%CACHELINE)%CACHELINE;
+}
+
+
+static char *allocateArray (Heap *H, Allocator *A, int capacity) {
+	size_t offset=heapOffset(H,A), size;
+	char *block;
+	
+	COUNTSTATISTIC(H,allocations);
+	if(A!=NULL) return allocateMemory(A,H->slotSize*(capacity+1));
+	size=(offset+H->slotSize*(capacity+1)+CACHELINE-1)/CACHELINE*CACHELINE;
+	block=aligned_alloc(CACHELINE,size);
+	if(block==NULL) return NULL;
+	return block+offset;
+}
+
+
+static void releaseArray (Heap *H, Allocator *A, char *heap) {
+	COUNTSTATISTIC(H,frees);
+	releaseMemory(A,heap-heapOffset(H,A));
+}
+
+
+static char *slotHeap (Heap *H, int i) {
+	return H->heap+(size_t)i*H->slotSize;
+}
+
+
+static void *itemHeap (Heap *H, int i) {
+	if(H->itemSize==0) return ((void **)H->heap)[i];
+	return slotHeap(H,i);
+}
+
+
+/* Moves the items of a Heap to an array with room for capacity
+ * items. */
+static int resize (Heap *H, int capacity) {
+	char *heap;
+	int *handles;
+	int resized=1;
+	
+	assert(capacity >= H->numberOfItems);
+	if(H->handles!=NULL) {
+		handles=resizeMemory(H->allocator,H->handles,sizeof(int)*(H->numberOfItems+1),
+							sizeof(int)*(capacity+1));
+		if(handles==NULL) resized=0;
+		else H->handles=handles;
+	}
+	if(resized) {
+		heap=allocateArray(H,H->allocator,capacity);
+		if(heap==NULL) resized=0;
+		else {
+			memcpy(heap,H->heap,H->slotSize*(H->numberOfItems+1));
+			releaseArray(H,H->allocator,H->heap);
+			H->heap=heap;
+		}
+	}
+	/* Both arrays have room for the smaller capacity even if only
+	 * one of them could be moved. */
+	if(resized || capacity<H->capacity) H->capacity=capacity;
+	return resized;
+}
+
+
+/* Makes room for count handles in the positions of a Heap. */
+static int reserveHandles (Heap *H, int count) {
+	int *positions;
+	
+	if(count<=H->handleCapacity) return 1;
+	positions=resizeMemory(H->allocator,H->positions,sizeof(int)*(H->handleCapacity+1),
+						sizeof(int)*(count+1));
+	if(positions==NULL) return 0;
+	H->positions=positions;
+	H->handleCapacity=count;
+	return 1;
+}
+
+
+/* Gives the item in slot s a handle, reusing the handle of a
+ * removed item when there is one. */
+static int newHandle (Heap *H, int s) {
+	int handle;
+	
+	if(H->freeHandle!=0) {
+		handle=H->freeHandle;
+		H->freeHandle=-H->positions[handle];
 	}
-	
-	N->parent=Q;
-	if(Q==NULL) T->root=N;
-	else if(T->compareItems(I,Q->item)<0) Q->left=N;
-	else Q->right=N;
-	T->size++;
-	return N;
+	else {
+		if(H->numberOfHandles==H->handleCapacity && !reserveHandles(H,2*H->handleCapacity+1))
+			return 0;
+		handle=++H->numberOfHandles;
+	}
+	H->handles[s]=handle;
+	H->positions[handle]=s;
+	return handle;
 }
 
 
-static TreeNode *minimum (TreeNode *N) {
-	while(N->left!=NULL) N=N->left;
-	return N;
+static void releaseHandle (Heap *H, int handle) {
+	H->positions[handle]=-H->freeHandle;
+	H->freeHandle=handle;
 }
 
 
-static int height (TreeNode *N) {
-	int hleft, hright;
-	if(N==NULL) return -1;
-	hleft=height(N->left);
-	hright=height(N->right);
-	if(hleft<hright) return 1+hright;
-	else return 1+hleft;
+/* Moves the item in slot s to slot d, along with its handle. */
+static void moveSlot (Heap *H, int d, int s) {
+	if(H->itemSize==0) ((void **)H->heap)[d]=((void **)H->heap)[s];
+	else memcpy(slotHeap(H,d),slotHeap(H,s),H->slotSize);
+	if(H->handles!=NULL) {
+		H->handles[d]=H->handles[s];
+		H->positions[H->handles[d]]=d;
+	}
 }
 
 
-static int balanced (TreeNode *N) {
-	int hleft, hright;
-	if(N==NULL) return -1;
-	hleft=balanced(N->left);
-	if(hleft==-2) return -2;
-	hright=balanced(N->right);
-	if(hright==-2) return -2;
-	if(hleft-hright<-1 || hleft-hright>1) return -2;
-	if(hleft<hright) return 1+hright;
-	else return 1+hleft;
+static int initialize (Heap *H,
+					int capacity,
+					size_t itemSize,
+					void * (*copyItem) (void *, void *),
+					void (*destroyItem) (void *),
+					int (*compareItems) (void *, void *)) {
+	CLEARSTATISTICS(H);
+	H->itemSize=itemSize;
+	H->slotSize=itemSize==0 ? sizeof(void *) : itemSize;
+	H->heap=allocateArray(H,NULL,capacity);
+	if(H->heap==NULL) return 0;
+	H->arity=2;
+	H->bound=0;
+	H->order=1;
+	H->handles=NULL;
+	H->positions=NULL;
+	H->handleCapacity=0;
+	H->numberOfHandles=0;
+	H->freeHandle=0;
+	H->capacity=capacity;
+	H->numberOfItems=0;
+	H->allocator=NULL;
+	H->copyItem=copyItem;
+	H->destroyItem=destroyItem;
+	H->compareItems=compareItems;
+	return 1;
 }
 
 
-static void destroy (TreeNode *N, Tree *T) {
-	if(N!=NULL) {
-		destroy(N->left,T);
-		destroy(N->right,T);
-		T->destroyItem(N->item);
-		free(N);
-	}
+int initializeHeap (Heap *H,
+				int capacity,
+				void * (*copyItem) (void *, void *),
+				void (*destroyItem) (void *),
+				int (*compareItems) (void *, void *)) {
+	return initialize(H,capacity,0,copyItem,destroyItem,compareItems);
 }
 
 
-void initializeAVL (Tree *T,
-				 void * (*copyItem) (void *, void *),
-				 void (*destroyItem) (void *),
-				 int (*compareItems) (void *, void *)) {
-	T->root=NULL;
-	T->copyItem=copyItem;
-	T->destroyItem=destroyItem;
-	T->compareItems=compareItems;
-	T->size=0;
+int initializeInlineHeap (Heap *H,
+					  int capacity,
+					  size_t itemSize,
+					  int (*compareItems) (void *, void *)) {
+	assert(itemSize > 0);
+	return initialize(H,capacity,itemSize,NULL,NULL,compareItems);
 }
 
 
-void insertAVL (Tree *T, void *I) {
-	TreeNode *N, *A, *B, *C, *P;
-	TreeNode *T1, *T2, *T3, *T4;
-	int i;
-	
-	N=insert(T,I);
-	if(N->parent==NULL || N->parent->parent==NULL) return;
-	while(balanced(N->parent->parent)!=-2) {
-		N=N->parent;
-		if(N->parent->parent==NULL) return;
-	}
+/* Compares the items in two slots in the order of the Heap, which
+ * a bounded Heap reverses. */
+static int compareSlots (Heap *H, int i, int j) {
+	COUNTSTATISTIC(H,comparisons);
+	return H->order*H->compareItems(itemHeap(H,i),itemHeap(H,j));
+}
+
+
+/* The sifts park the moving item in slot 0, which is never used
+ * otherwise, and shift the items it passes by one level, so each
+ * level costs one move instead of a swap. */
+static int siftUp (Heap *H, int child) {
+	int parent;
 	
-	A=N; B=N->parent;
-	C=B->parent; P=C->parent;
-	if(P==NULL) i=0;
-	else if(P->left==C) i=-1;
-	else i=1;
+	if(child==1 || compareSlots(H,child,PARENT(H,child))<=0)
+		return child;
+	moveSlot(H,0,child);
+	do {
+		parent=PARENT(H,child);
+		if(compareSlots(H,0,parent)<=0) break;
+		moveSlot(H,child,parent);
+		COUNTSTATISTIC(H,siftSteps);
+		child=parent;
+	} while(child!=1);
+	moveSlot(H,child,0);
+	return child;
+}
+
+
+static void siftDown (Heap *H, int parent) {
+	int first, last, child, i, moved=0;
 	
-	if(C->left==B) 
-		if(B->left==A) {
-			T2=A->right; T3=B->right; 
-		}
-		else {
-			N=A; A=B; B=N;
-			T2=B->left; T3=B->right; 
-		}
-	else 
-		if(B->left==A) {
-			N=A; A=C; C=B; B=N;
-			T2=B->left; T3=B->right; 
+	while((first=FIRSTCHILD(H,parent))<=H->numberOfItems) {
+		last=first+H->arity-1;
+		if(last>H->numberOfItems) last=H->numberOfItems;
+		child=first;
+		for(i=first+1;i<=last;i++)
+			if(compareSlots(H,i,child)>0) child=i;
+		if(compareSlots(H,child,moved ? 0 : parent)<=0) break;
+		if(!moved) {
+			moveSlot(H,0,parent);
+			moved=1;
 		}
-		else {
-			N=A; A=C; C=N;
-			T2=B->left; T3=C->left;
-		}	
+		moveSlot(H,parent,child);
+		COUNTSTATISTIC(H,siftSteps);
+		parent=child;
+	}
+	if(moved) moveSlot(H,parent,0);
+}
+
+
+/* Stores a copy of I in the empty slot s. */
+static int storeHeap (Heap *H, int s, void *I) {
+	void *temp;
 	
-	T1=A->left; T4=C->right;
-	A->right=T2; C->left=T3;
-	B->left=A; B->right=C; 
-	A->parent=B; C->parent=B;
-	if(T1!=NULL) T1->parent=A; 
-	if(T2!=NULL) T2->parent=A;
-	if(T3!=NULL) T3->parent=C;
- 	if(T4!=NULL) T4->parent=C;
-	if(i==0) {T->root=B; B->parent=NULL;}
-	else if(i==-1) {P->left=B; B->parent=P;}
-	else {P->right=B; B->parent=P;}
+	if(H->itemSize!=0) memcpy(slotHeap(H,s),I,H->itemSize);
+	else {
+		temp=H->copyItem(NULL,I);
+		if(temp==NULL) return 0;
+		COUNTSTATISTIC(H,allocations);
+		((void **)H->heap)[s]=temp;
+	}
+	return 1;
 }
 
 
-int minimumAVL (Tree *T, void *I) {
-	TreeNode *N;
-	if(T->root==NULL) return 0;
-	N=minimum(T->root);
-	T->current=N;
-	T->copyItem(I,N->item);
+/* Destroys the copy of the item in slot s, if the Heap made one. */
+static void destroyHeapSlot (Heap *H, int s) {
+	if(H->itemSize!=0) return;
+	H->destroyItem(itemHeap(H,s));
+	COUNTSTATISTIC(H,frees);
+}
+
+
+/* Keeps the largest items of a full bounded Heap: I takes the
+ * place of the smallest one, at the top, if it is larger. */
+static void replaceTop (Heap *H, void *I) {
+	COUNTSTATISTIC(H,comparisons);
+	if(H->compareItems(I,itemHeap(H,1))<=0) return;
+	if(H->itemSize==0) H->copyItem(itemHeap(H,1),I);
+	else memcpy(slotHeap(H,1),I,H->itemSize);
+	siftDown(H,1);
+}
+
+
+int insertHeap (Heap *H, void *I) {
+	int handle=1, capacity;
+
+	if(H->bound!=0 && H->numberOfItems==H->bound) {
+		replaceTop(H,I);
+		return 1;
+	}
+	if(fullHeap(H)) {
+		capacity=2*H->capacity+1;
+		if(H->bound!=0 && capacity>H->bound) capacity=H->bound;
+		if(!resize(H,capacity)) return 0;
+	}
+	if(H->handles!=NULL && (handle=newHandle(H,H->numberOfItems+1))==0) return 0;
+	if(!storeHeap(H,H->numberOfItems+1,I)) {
+		if(H->handles!=NULL) releaseHandle(H,handle);
+		return 0;
+	}
+	H->numberOfItems++;
+	siftUp(H,H->numberOfItems);
+	return handle;
+}
+
+
+/* Sifts down in a 0-indexed array, as heapSort needs. */
+static void siftDownArray (void **items, int n, int parent,
+						int (*compareItems) (void *, void *)) {
+	int child;
+	void *temp;
+	
+	child=2*parent+1;
+	while(child<n) {
+		if(child+1<n && compareItems(items[child],items[child+1])<0) child++;
+		if(compareItems(items[child],items[parent])<=0) return;
+		temp=items[parent];
+		items[parent]=items[child];
+		items[child]=temp;
+		parent=child;
+		child=2*parent+1;
+	}
+}
+
+
+int buildHeap (Heap *H, void **items, int n) {
+	int i;
+	
+	assert(emptyHeap(H));
+	if(H->bound!=0) return insertBatchHeap(H,items,n);
+	if(!reserveHeap(H,n)) return 0;
+	if(H->handles!=NULL) {
+		if(!reserveHandles(H,n)) return 0;
+		H->numberOfHandles=n;
+		H->freeHandle=0;
+		for(i=1;i<=n;i++) H->handles[i]=H->positions[i]=i;
+	}
+	for(i=0;i<n;i++) {
+		if(!storeHeap(H,i+1,items[i])) {
+			while(H->numberOfItems>0) destroyHeapSlot(H,H->numberOfItems--);
+			H->numberOfHandles=0;
+			return 0;
+		}
+		H->numberOfItems++;
+	}
+	if(H->numberOfItems>1)
+		for(i=PARENT(H,H->numberOfItems);i>=1;i--) siftDown(H,i);
 	return 1;
 }
 
 
-int successorAVL (Tree *T, void *I) {
-	TreeNode *N, *P;
-	if(T->root==NULL) return 0;
-	if((N=T->current->right)!=NULL) {
-		P=minimum(N);
-		T->current=P;
-		T->copyItem(I,P->item);
+int insertBatchHeap (Heap *H, void **items, int n) {
+	int i, first=H->numberOfItems+1, capacity;
+	
+	if(H->bound!=0) {
+		for(i=0;i<n;i++)
+			if(!insertHeap(H,items[i])) return 0;
 		return 1;
 	}
-	N=T->current;
-	P=N->parent;
-	while(P!=NULL && N==P->right) {
-		N=P;
-		P=P->parent;
+	if(H->numberOfItems+n>H->capacity) {
+		capacity=2*H->capacity+1;
+		if(capacity<H->numberOfItems+n) capacity=H->numberOfItems+n;
+		if(!resize(H,capacity)) return 0;
 	}
-	if(P==NULL) return 0;
-	T->current=P;
-	T->copyItem(I,P->item);
+	if(H->handles!=NULL && !reserveHandles(H,H->numberOfHandles+n)) return 0;
+	for(i=0;i<n;i++) {
+		if(!storeHeap(H,first+i,items[i])) {
+			while(--i>=0) {
+				destroyHeapSlot(H,first+i);
+				if(H->handles!=NULL) releaseHandle(H,H->handles[first+i]);
+			}
+			return 0;
+		}
+		if(H->handles!=NULL) newHandle(H,first+i);
+	}
+	H->numberOfItems+=n;
+	/* Sifting up a batch at least as large as the Heap costs more
+	 * than heapifying everything again. */
+	if(n>=first-1) {
+		if(H->numberOfItems>1)
+			for(i=PARENT(H,H->numberOfItems);i>=1;i--) siftDown(H,i);
+	}
+	else for(i=first;i<=H->numberOfItems;i++) siftUp(H,i);
 	return 1;
 }
 
 
-int sizeAVL (Tree *T) {
-	return T->size;
+/* Takes the item in slot s out of the Heap without destroying
+ * it. The last item takes its place. */
+static void detach (Heap *H, int s) {
+	if(H->handles!=NULL) releaseHandle(H,H->handles[s]);
+	if(s<H->numberOfItems) moveSlot(H,s,H->numberOfItems);
+	H->numberOfItems--;
+	if(s<=H->numberOfItems) siftDown(H,siftUp(H,s));
 }
 
 
-int heightAVL (Tree *T) {
-	return height(T->root);
+/* Removes the item in slot s, whose place is taken by the last
+ * item. */
+static void removeAt (Heap *H, int s) {
+	destroyHeapSlot(H,s);
+	detach(H,s);
 }
 
 
-int balancedAVL (Tree *T) {
-	if(balanced(T->root)==-2) return 0;
-	return 1;
+void removeHeap (Heap *H) {
+	removeAt(H,1);
 }
 
 
-void destroyAVL (Tree *T) {
-	destroy(T->root,T);	
+int popBatchHeap (Heap *H, void *out, int k) {
+	int i;
+	
+	if(k>H->numberOfItems) k=H->numberOfItems;
+	for(i=0;i<k;i++) {
+		if(H->itemSize==0) ((void **)out)[i]=itemHeap(H,1);
+		else memcpy((char *)out+(size_t)i*H->itemSize,slotHeap(H,1),H->itemSize);
+		detach(H,1);
+	}
+	return k;
 }
 
-///////////////////////////////////////////////////////////////////////
+
+static int validHandle (Heap *H, int handle) {
+	return H->handles!=NULL && handle>=1 && handle<=H->numberOfHandles && H->positions[handle]>0;
+}
 
 
-// Heap Implementation
-///////////////////////////////////////////////////////////////////////
+void updateKeyHeap (Heap *H, int handle, void *I) {
+	int s;
+	
+	assert(validHandle(H,handle));
+	s=H->positions[handle];
+	if(H->itemSize==0) H->copyItem(itemHeap(H,s),I);
+	else memcpy(slotHeap(H,s),I,H->itemSize);
+	siftDown(H,siftUp(H,s));
+}
 
-int initializeHeap (Heap *H,
-				int capacity,
-				void * (*copyItem) (void *, void *),
-				void (*destroyItem) (void *),
-				int (*compareItems) (void *, void *)) {
-	H->heap=malloc(sizeof(void *)*(capacity+1));
-	if(H->heap==NULL) return 0;
-	H->capacity=capacity;
-	H->numberOfItems=0;
-	H->copyItem=copyItem;
-	H->destroyItem=destroyItem;
-	H->compareItems=compareItems;
-	return 1;
+
+void removeAtHeap (Heap *H, int handle) {
+	assert(validHandle(H,handle));
+	removeAt(H,H->positions[handle]);
 }
 
 
-int insertHeap (Heap *H, void *I) {
-	int parent, child;
-	void *temp;
+void setArityHeap (Heap *H, int arity) {
+	assert(emptyHeap(H) && arity>=2);
+	H->arity=arity;
+}
 
-	temp=H->copyItem(NULL,I);
-	if(temp==NULL) return 0;
-	H->numberOfItems++;
-	H->heap[H->numberOfItems]=temp;
-	
-	child=H->numberOfItems;
-	parent=child/2;
-	while(child!=1 && H->compareItems(H->heap[child],H->heap[parent])>0) {
-		temp=H->heap[parent];
-		H->heap[parent]=H->heap[child];
-		H->heap[child]=temp;
-		child=parent;
-		parent=child/2;
+
+int setBoundHeap (Heap *H, int bound) {
+	assert(emptyHeap(H) && bound>=0 && H->handles==NULL);
+	H->bound=bound;
+	H->order=bound==0 ? 1 : -1;
+	return reserveHeap(H,bound);
+}
+
+
+int setIndexedHeap (Heap *H) {
+	int *handles, *positions;
+	
+	assert(emptyHeap(H) && H->bound==0);
+	if(H->handles!=NULL) return 1;
+	handles=allocateMemory(H->allocator,sizeof(int)*(H->capacity+1));
+	if(handles==NULL) return 0;
+	positions=allocateMemory(H->allocator,sizeof(int)*(H->capacity+1));
+	if(positions==NULL) {
+		releaseMemory(H->allocator,handles);
+		return 0;
 	}
+	H->handles=handles;
+	H->positions=positions;
+	H->handleCapacity=H->capacity;
+	H->numberOfHandles=0;
+	H->freeHandle=0;
 	return 1;
 }
 
 
-void removeHeap (Heap *H) {
-	int parent, child;
-	void *temp;
-	
-	H->destroyItem(H->heap[1]);
-	H->heap[1]=H->heap[H->numberOfItems];
-	H->numberOfItems--;
+int setAllocatorHeap (Heap *H, Allocator *A) {
+	char *heap;
+	int *handles=NULL, *positions=NULL;
 	
-	parent=1;
-	child=2; 
-	if(child<H->numberOfItems && H->compareItems(H->heap[child],H->heap[child+1])<0)
-		child++;
-	while(child<=H->numberOfItems && H->compareItems(H->heap[child],H->heap[parent])>0) {
-		temp=H->heap[parent];
-		H->heap[parent]=H->heap[child];
-		H->heap[child]=temp;
-		parent=child;
-		child=parent*2;
-		if(child<H->numberOfItems && H->compareItems(H->heap[child],H->heap[child+1])<0)
-			child++;		
+	assert(emptyHeap(H));
+	heap=allocateArray(H,A,H->capacity);
+	if(heap==NULL) return 0;
+	if(H->handles!=NULL) {
+		handles=allocateMemory(A,sizeof(int)*(H->capacity+1));
+		positions=handles==NULL ? NULL : allocateMemory(A,sizeof(int)*(H->capacity+1));
+		if(positions==NULL) {
+			if(handles!=NULL) releaseMemory(A,handles);
+			releaseArray(H,A,heap);
+			return 0;
+		}
+		releaseMemory(H->allocator,H->handles);
+		releaseMemory(H->allocator,H->positions);
+		H->handleCapacity=H->capacity;
+		H->numberOfHandles=0;
+		H->freeHandle=0;
 	}
+	releaseArray(H,H->allocator,H->heap);
+	H->heap=heap;
+	H->handles=handles;
+	H->positions=positions;
+	H->allocator=A;
+	return 1;
+}
+
+
+int reserveHeap (Heap *H, int capacity) {
+	if(capacity<=H->capacity) return 1;
+	return resize(H,capacity);
+}
+
+
+int shrinkHeap (Heap *H) {
+	if(H->capacity==H->numberOfItems) return 1;
+	return resize(H,H->numberOfItems);
 }
 
 
 void topHeap (Heap *H, void *I) {
-	H->copyItem(I,H->heap[1]);
+	if(H->itemSize==0) H->copyItem(I,itemHeap(H,1));
+	else memcpy(I,slotHeap(H,1),H->itemSize);
 }
 
 
@@ -611,11 +2514,160 @@ int emptyHeap (Heap *H) {
 }
 
 
+Statistics statsHeap (Heap *H) {
+	return STATISTICS(H);
+}
+
+
 void destroyHeap (Heap *H) {
 	int i;
-	for(i=1;i<=H->numberOfItems;i++)	
-		H->destroyItem(H->heap[i]);
-	free(H->heap);
+	for(i=1;i<=H->numberOfItems;i++) destroyHeapSlot(H,i);
+	releaseArray(H,H->allocator,H->heap);
+	if(H->handles!=NULL) {
+		releaseMemory(H->allocator,H->handles);
+		releaseMemory(H->allocator,H->positions);
+	}
+}
+
+
+void heapSort (void **items, int n, int (*compareItems) (void *, void *)) {
+	int i;
+	void *temp;
+	
+	for(i=n/2-1;i>=0;i--) siftDownArray(items,n,i,compareItems);
+	for(i=n-1;i>0;i--) {
+		temp=items[0];
+		items[0]=items[i];
+		items[i]=temp;
+		siftDownArray(items,i,0,compareItems);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////
+
+// Concurrent Heap Implementation
+///////////////////////////////////////////////////////////////////////
+
+/* Picks a queue with a xorshift generator of the calling thread, so
+ * that threads do not share a seed. */
+static int randomQueue (ConcurrentHeap *C) {
+	static _Thread_local unsigned int seed;
+	
+	if(seed==0) seed=(unsigned int)(size_t)&seed|1;
+	seed^=seed<<13;
+	seed^=seed>>17;
+	seed^=seed<<5;
+	return seed%C->numberOfQueues;
+}
+
+
+/* Locks a random queue, trying others while they are busy before
+ * waiting for one. */
+static LockedHeap *lockQueue (ConcurrentHeap *C) {
+	LockedHeap *Q;
+	int i;
+	
+	for(i=0;i<C->numberOfQueues;i++) {
+		Q=&C->queues[randomQueue(C)];
+		if(pthread_mutex_trylock(&Q->lock)==0) return Q;
+	}
+	Q=&C->queues[randomQueue(C)];
+	pthread_mutex_lock(&Q->lock);
+	return Q;
+}
+
+
+/* Takes the top item out of the locked queue Q and unlocks it, so
+ * that the item is copied and destroyed outside the lock. */
+static void popQueue (LockedHeap *Q, void *I) {
+	void *item;
+	
+	popBatchHeap(&Q->heap,&item,1);
+	pthread_mutex_unlock(&Q->lock);
+	Q->heap.copyItem(I,item);
+	Q->heap.destroyItem(item);
+}
+
+
+int initializeConcurrentHeap (ConcurrentHeap *C,
+						 int numberOfQueues,
+						 void * (*copyItem) (void *, void *),
+						 void (*destroyItem) (void *),
+						 int (*compareItems) (void *, void *)) {
+	int i;
+	
+	assert(numberOfQueues >= 1);
+	C->queues=aligned_alloc(CACHELINE,sizeof(LockedHeap)*numberOfQueues);
+	if(C->queues==NULL) return 0;
+	for(i=0;i<numberOfQueues;i++)
+		if(!initializeHeap(&C->queues[i].heap,0,copyItem,destroyItem,compareItems)) {
+			while(--i>=0) destroyHeap(&C->queues[i].heap);
+			free(C->queues);
+			return 0;
+		}
+	for(i=0;i<numberOfQueues;i++) pthread_mutex_init(&C->queues[i].lock,NULL);
+	C->numberOfQueues=numberOfQueues;
+	return 1;
+}
+
+
+int insertConcurrentHeap (ConcurrentHeap *C, void *I) {
+	LockedHeap *Q;
+	int inserted;
+	
+	Q=lockQueue(C);
+	inserted=insertHeap(&Q->heap,I);
+	pthread_mutex_unlock(&Q->lock);
+	return inserted!=0;
+}
+
+
+int removeConcurrentHeap (ConcurrentHeap *C, void *I) {
+	LockedHeap *Q, *R, *temp;
+	int i, start;
+	
+	for(i=0;i<C->numberOfQueues;i++) {
+		Q=lockQueue(C);
+		R=&C->queues[randomQueue(C)];
+		if(R!=Q && pthread_mutex_trylock(&R->lock)==0) {
+			if(emptyHeap(&Q->heap) || (!emptyHeap(&R->heap)
+				&& Q->heap.compareItems(itemHeap(&R->heap,1),itemHeap(&Q->heap,1))>0)) {
+				temp=Q;
+				Q=R;
+				R=temp;
+			}
+			pthread_mutex_unlock(&R->lock);
+		}
+		if(!emptyHeap(&Q->heap)) {
+			popQueue(Q,I);
+			return 1;
+		}
+		pthread_mutex_unlock(&Q->lock);
+	}
+	/* The sampled queues were empty: look at every queue before
+	 * reporting that the Concurrent Heap is. */
+	start=randomQueue(C);
+	for(i=0;i<C->numberOfQueues;i++) {
+		Q=&C->queues[(start+i)%C->numberOfQueues];
+		pthread_mutex_lock(&Q->lock);
+		if(!emptyHeap(&Q->heap)) {
+			popQueue(Q,I);
+			return 1;
+		}
+		pthread_mutex_unlock(&Q->lock);
+	}
+	return 0;
+}
+
+
+void destroyConcurrentHeap (ConcurrentHeap *C) {
+	int i;
+	
+	for(i=0;i<C->numberOfQueues;i++) {
+		pthread_mutex_destroy(&C->queues[i].lock);
+		destroyHeap(&C->queues[i].heap);
+	}
+	free(C->queues);
 }
 
-///////////////////////////////////////////////////////////////////////
\ No newline at end of file
+///////////////////////////////////////////////////////////////////////
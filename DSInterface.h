@@ -5,9 +5,70 @@
 #include "ListType.h"
 #include <string.h>
 
+// Pool Interface
+///////////////////////////////////////////////////////////////////////
+
+/*********************************************************************
+ * An Allocator is a set of functions the structures below may get
+ * their memory from (see the setAllocator functions):
+ *   . allocate (void *context, size_t size) returns the address of
+ *     size bytes of memory, or NULL
+ *   . release (void *context, void *p) frees memory returned by
+ *     allocate
+ *   . releaseAll (void *context) frees all the memory returned by
+ *     allocate at once; it may be NULL
+ * The context field is passed as the first argument of each one.
+ *********************************************************************/
+
+/*********************************************************************
+ * FUNCTION NAME: initializePool
+ * PURPOSE: Sets a Pool variable to the empty Pool. A Pool hands out
+ *          objects of one size carved out of pages of memory, which
+ *          suits the nodes of Lists and Trees.
+ * ARGUMENTS: . The address of the Pool variable to be initialized
+ *              (Pool *)
+ *            . The number of objects per page (int)
+ * REQUIRES: The number of objects per page should be positive.
+ * NOTES: . The size of the objects is the size of the first
+ *          allocation; larger allocations fail.
+ *        . Initialize is the only function that may be used right
+ *          after the declaration of the Pool variable or a call
+ *          to Destroy, and it should not be used otherwise.
+ *********************************************************************/
+extern void initializePool (Pool *P, int objectsPerPage);
+
+/*********************************************************************
+ * FUNCTION NAME: allocatorPool
+ * PURPOSE: Finds the Allocator that gets memory from a Pool.
+ * ARGUMENTS: The address of the Pool (Pool *)
+ * RETURNS: The address of the Allocator (Allocator *), whose
+ *          releaseAll function frees every page of the Pool
+ *********************************************************************/
+extern Allocator *allocatorPool (Pool *P);
+
+/*********************************************************************
+ * FUNCTION NAME: destroyPool
+ * PURPOSE: Frees every page of a Pool.
+ * ARGUMENTS: The address of the Pool to be destroyed (Pool *)
+ * NOTES: The structures using the Pool should be destroyed first.
+ *********************************************************************/
+extern void destroyPool (Pool *P);
+
+///////////////////////////////////////////////////////////////////////
+
+
 // Linked-List Interface
 ///////////////////////////////////////////////////////////////////////
 
+/*********************************************************************
+ * A List keeps its Items in a doubly-linked list of chunks of up to
+ * LISTCHUNKSIZE Items each. Finding a position skips whole chunks
+ * from the closer end, and the ends are reached in O(1) time. A
+ * doubly-linked List keeps each Item in a chunk of its own, which
+ * then names the Item until it is deleted, so that it can be
+ * unlinked in O(1) time.
+ *********************************************************************/
+
 /*********************************************************************
  * FUNCTION NAME: initializeList
  * PURPOSE: Sets a List variable to the empty List.
@@ -22,6 +83,39 @@
  *********************************************************************/
 extern void initializeList (List *L);
 
+/*********************************************************************
+ * FUNCTION NAME: initializeDoublyList
+ * PURPOSE: Sets a List variable to the empty List that keeps each
+ *          Item in a chunk of its own, so that the chunk of an Item
+ *          can be unlinked without a walk.
+ * ARGUMENTS: The address of the List variable to be initialized
+ *            (List *) 
+ * ENSURES: . Empty will return true (a nonzero integer).
+ *          . Full will return false (0).
+ *          . Length will return 0.
+ * NOTES: . Chunks are allocated with room for one Item only, and
+ *          never split or merge, so Items move between chunks only
+ *          when the List is sorted.
+ *        . Initialize is the only function that may be used right
+ *          after the declaration of the List variable or a call
+ *          to Destroy, and it should not be used otherwise.
+ *********************************************************************/
+extern void initializeDoublyList (List *L);
+
+/*********************************************************************
+ * FUNCTION NAME: setAllocatorList
+ * PURPOSE: Makes a List get its memory from an Allocator
+ *          instead of malloc and free.
+ * ARGUMENTS: . The address of the List (List *)
+ *            . The address of the Allocator (Allocator *),
+ *              or NULL to go back to malloc and free
+ * REQUIRES: The List should be empty.
+ * NOTES: If the Allocator has a releaseAll function, Destroy calls
+ *        it instead of releasing the nodes one at a time, so such an
+ *        Allocator should not be shared with another structure.
+ *********************************************************************/
+extern void setAllocatorList (List *L, Allocator *A);
+
 /*********************************************************************
  * FUNCTION NAME: insertList
  * PURPOSE: Inserts an Item in a List.
@@ -40,6 +134,30 @@ extern void initializeList (List *L);
  *********************************************************************/
 extern void insertList (Item X, int position, List *L);
 
+/*********************************************************************
+ * FUNCTION NAME: appendList
+ * PURPOSE: Inserts an Item at the end of a List, in O(1) time.
+ * ARGUMENTS: . The Item to be inserted (Item)
+ *            . The address of the List (List *L)
+ * RETURNS: The address of the chunk that holds the Item (ListChunk *)
+ * ENSURES: . Peek in the last position will find the Item.
+ *          . Every ListCursor on the List stays valid.
+ *********************************************************************/
+extern ListChunk *appendList (Item X, List *L);
+
+/*********************************************************************
+ * FUNCTION NAME: nodeList
+ * PURPOSE: Finds the chunk that holds an Item of a List.
+ * ARGUMENTS: . The position in the List where the Item is in (int) 
+ *            . The address of the List (List *L)
+ * REQUIRES: The position should be a nonnegative integer
+ *           lower than the length of the List.
+ * RETURNS: The address of the chunk (ListChunk *), which in a
+ *          doubly-linked List holds only that Item until it is
+ *          deleted or the List is sorted
+ *********************************************************************/
+extern ListChunk *nodeList (int position, List *L);
+
 /*********************************************************************
  * FUNCTION NAME: deleteList
  * PURPOSE: Deletes an Item from a List.
@@ -55,12 +173,25 @@ extern void insertList (Item X, int position, List *L);
  *********************************************************************/
 extern void deleteList (int position, List *L);
 
+/*********************************************************************
+ * FUNCTION NAME: unlinkList
+ * PURPOSE: Deletes the Item held by a chunk from a doubly-linked
+ *          List, in O(1) time.
+ * ARGUMENTS: . The address of the chunk (ListChunk *), as returned
+ *              by Append or Node
+ *            . The address of the List (List *L)
+ * REQUIRES: The List should have been initialized by
+ *           initializeDoublyList, and the chunk should be in it.
+ * ENSURES: Length will return the first integer lower
+ *          than the length of the List before the call.
+ *********************************************************************/
+extern void unlinkList (ListChunk *N, List *L);
+
 /*********************************************************************
  * FUNCTION NAME: fullList
  * PURPOSE: Determines whether a List is full.
  * ARGUMENTS: The address of the List (List *) 
- * RETURNS: True (a nonzero integer) if the List is full,
- *          false (0) otherwise
+ * RETURNS: False (0), since a List grows as long as memory lasts
  *********************************************************************/
 extern int fullList (List *L);
 
@@ -108,11 +239,119 @@ extern void destroyList (List *L);
  * PURPOSE: Reverses a List
             (the first Item becomes the last and vice versa).
  * ARGUMENTS: The address of the List to be reversed (List *)
- * Note: some concepts borrowed from: 
- *       stackoverflow.com/questions/2434411
+ * NOTE: Takes O(n) time and no extra memory.
  *********************************************************************/
 extern void reverseList (List *L);
 
+/*********************************************************************
+ * FUNCTION NAME: sortList
+ * PURPOSE: Sorts a List in increasing order, keeping Items that
+ *          are equal in the order they were in, in O(n log n) time.
+ * ARGUMENTS: . The address of the List to be sorted (List *)
+ *            . A pointer to a compare function
+ *              -------------------------------
+ *              PURPOSE: Compares two Items.
+ *              ARGUMENTS: . The address of a first Item (Item *)
+ *                         . The address of a second Item (Item *)
+ *              RETURNS: A negative integer if the 1st Item is less
+ *                       than the 2nd Item, 0 if the two Items are
+ *                       equal, a positive integer otherwise
+ *              -------------------------------
+ * NOTES: . The sort merges runs of whole chunks, moving Items into
+ *          chunks the merge has emptied, so it needs only a couple
+ *          of chunks beyond those of the List.
+ *        . Every chunk but the last is full afterwards.
+ *        . In a doubly-linked List, the chunks held before the sort
+ *          hold other Items afterwards.
+ *********************************************************************/
+extern void sortList (List *L, int (*compareItems) (Item *, Item *));
+
+///////////////////////////////////////////////////////////////////////
+
+
+// List Cursor Interface
+///////////////////////////////////////////////////////////////////////
+
+/*********************************************************************
+ * A ListCursor holds a position in a List, so that a pass over the
+ * List moves, peeks, inserts and deletes in O(1) time instead of
+ * finding each position from an end. A cursor is either on an Item
+ * or off the List. Append leaves every cursor valid; otherwise,
+ * inserting or deleting through anything but the cursor leaves it
+ * undefined, except in a doubly-linked List, whose Items stay in
+ * their chunks, where only deleting the Item the cursor is on does.
+ *********************************************************************/
+
+/*********************************************************************
+ * FUNCTION NAME: initializeListCursor
+ * PURPOSE: Sets a ListCursor variable to a cursor off a List.
+ * ARGUMENTS: . The address of the ListCursor variable to be
+ *              initialized (ListCursor *)
+ *            . The address of the List (List *)
+ *********************************************************************/
+extern void initializeListCursor (ListCursor *C, List *L);
+
+/*********************************************************************
+ * FUNCTION NAME: firstListCursor
+ * PURPOSE: Moves a ListCursor to the first Item of its List.
+ * ARGUMENTS: The address of the ListCursor (ListCursor *)
+ * RETURNS: 1 if the cursor is on an Item, i.e., if the List is not
+ *          empty, 0 otherwise
+ *********************************************************************/
+extern int firstListCursor (ListCursor *C);
+
+/*********************************************************************
+ * FUNCTION NAME: seekListCursor
+ * PURPOSE: Moves a ListCursor to a position of its List.
+ * ARGUMENTS: . The address of the ListCursor (ListCursor *)
+ *            . The position (int)
+ * REQUIRES: The position should be a nonnegative integer.
+ * RETURNS: 1 if the cursor is on an Item, 0 if the position is not
+ *          lower than the length of the List, in which case the
+ *          cursor is off the List
+ *********************************************************************/
+extern int seekListCursor (ListCursor *C, int position);
+
+/*********************************************************************
+ * FUNCTION NAME: nextListCursor
+ * PURPOSE: Moves a ListCursor to the Item after its Item.
+ * ARGUMENTS: The address of the ListCursor (ListCursor *)
+ * RETURNS: 1 if the cursor is on an Item, 0 if it was on the
+ *          last Item or off the List
+ *********************************************************************/
+extern int nextListCursor (ListCursor *C);
+
+/*********************************************************************
+ * FUNCTION NAME: peekListCursor
+ * PURPOSE: Finds the Item a ListCursor is on.
+ * ARGUMENTS: . The address of the ListCursor (ListCursor *)
+ *            . The address of the Item
+ *              the Item found should be copied to
+ * REQUIRES: The cursor should be on an Item.
+ *********************************************************************/
+extern void peekListCursor (ListCursor *C, Item *X);
+
+/*********************************************************************
+ * FUNCTION NAME: insertListCursor
+ * PURPOSE: Inserts an Item in a List after the Item a ListCursor is
+ *          on, or first if the cursor is off the List.
+ * ARGUMENTS: . The address of the ListCursor (ListCursor *)
+ *            . The Item to be inserted (Item)
+ * ENSURES: The cursor stays on the same Item, or off the List.
+ *********************************************************************/
+extern void insertListCursor (ListCursor *C, Item X);
+
+/*********************************************************************
+ * FUNCTION NAME: removeListCursor
+ * PURPOSE: Deletes the Item a ListCursor is on from its List, and
+ *          moves the cursor to the Item after it.
+ * ARGUMENTS: The address of the ListCursor (ListCursor *)
+ * REQUIRES: The cursor should be on an Item.
+ * RETURNS: 1 if the cursor is on an Item, 0 if the Item deleted was
+ *          the last one, in which case the cursor is off the List
+ *********************************************************************/
+extern int removeListCursor (ListCursor *C);
+
 ///////////////////////////////////////////////////////////////////////
 
 
@@ -133,33 +372,74 @@ extern void reverseList (List *L);
  *********************************************************************/
 extern void initializeStack (Stack *S);
 
+/*********************************************************************
+ * FUNCTION NAME: initializeBoundedStack
+ * PURPOSE: Sets a Stack variable to the empty Stack that holds at
+ *          most a number of Items.
+ * ARGUMENTS: . The address of the Stack variable to be initialized
+ *              (Stack *) 
+ *            . The number of Items (int)
+ * REQUIRES: The number of Items should be positive.
+ * RETURNS: True (a nonzero integer) if the room for the Items could
+ *          be allocated, false (0) otherwise, in which case the
+ *          Stack is empty and unbounded
+ * ENSURES: Full will return true once the Stack holds that many
+ *          Items, and Push will then fail.
+ * NOTES: May be used wherever Initialize may.
+ *********************************************************************/
+extern int initializeBoundedStack (Stack *S, int capacity);
+
+/*********************************************************************
+ * FUNCTION NAME: setAllocatorStack
+ * PURPOSE: Makes a Stack get the memory for its array from an
+ *          Allocator instead of malloc and free.
+ * ARGUMENTS: . The address of the Stack (Stack *)
+ *            . The address of the Allocator (Allocator *),
+ *              or NULL to go back to malloc and free
+ * REQUIRES: The Stack should be empty.
+ * RETURNS: True (a nonzero integer) if the array could be allocated,
+ *		    false (0) otherwise, in which case the Stack is unchanged
+ * NOTE: The array grows to blocks of any size, so a Pool does not
+ *       suit it.
+ *********************************************************************/
+extern int setAllocatorStack (Stack *S, Allocator *A);
+
+/*********************************************************************
+ * FUNCTION NAME: reserveStack
+ * PURPOSE: Makes room in a Stack for a number of Items, so that
+ *          Push does not have to grow it until that many Items
+ *          are stored.
+ * ARGUMENTS: . The address of the Stack (Stack *)
+ *            . The number of Items (int)
+ * RETURNS: True (a nonzero integer) if the room could be made,
+ *		    false (0) otherwise, in which case the Stack is unchanged
+ * NOTE: On a bounded Stack this raises the bound.
+ *********************************************************************/
+extern int reserveStack (Stack *S, int capacity);
+
 /*********************************************************************
  * FUNCTION NAME: pushStack
- * PURPOSE: Inserts an Item in a Stack.
+ * PURPOSE: Inserts an Item on top of a Stack.
  * ARGUMENTS: . The Item to be inserted (Item)
- *            . The position in the Stack
- *              where the Item should be inserted in (int) 
- *            . The address of the Stack (Stack *L)
- * REQUIRES: . The position should be a nonnegative integer
- *             not greater than the length of the Stack.
- *           . The Stack should not be full.
- * ENSURES: . Empty will return false (0).
+ *            . The address of the Stack (Stack *)
+ * RETURNS: True (a nonzero integer) if the Item was inserted,
+ *          false (0) if the Stack is full or could not grow, in
+ *          which case the Stack is unchanged
+ * ENSURES: If the Item was inserted,
+ *          . Empty will return false (0).
  *          . Length will return the first integer greater
  *            than the length of the Stack before the call.
- *          . Peek in the same position will find
- *            the Item that was inserted.
+ *          . Top will find the Item that was inserted.
+ * NOTE: The array of Items doubles when it is full, so a Push takes
+ *       O(1) amortized time and no allocation in most calls.
  *********************************************************************/
-extern void pushStack (Item X, Stack *S);
+extern int pushStack (Item X, Stack *S);
 
 /*********************************************************************
  * FUNCTION NAME: popStack
- * PURPOSE: Deletes an Item from a Stack.
- * ARGUMENTS: . The position in the Stack
- *              where the Item to be deleted is in (int) 
- *            . The address of the Stack (Stack *L)
- * REQUIRES: . The position should be a nonnegative integer
- *             lower than the length of the Stack.
- *           . The Stack should not be empty.
+ * PURPOSE: Deletes the Item on top of a Stack.
+ * ARGUMENTS: The address of the Stack (Stack *)
+ * REQUIRES: The Stack should not be empty.
  * ENSURES: . Full will return false (0).
  *          . Length will return the first integer lower
  *            than the length of the Stack before the call.
@@ -170,8 +450,8 @@ extern void popStack (Stack *S);
  * FUNCTION NAME: fullStack
  * PURPOSE: Determines whether a Stack is full.
  * ARGUMENTS: The address of the Stack (Stack *) 
- * RETURNS: True (a nonzero integer) if the Stack is full,
- *          false (0) otherwise
+ * RETURNS: True (a nonzero integer) if the Stack is bounded and
+ *          holds as many Items as its bound, false (0) otherwise
  *********************************************************************/
 extern int fullStack (Stack *S);
 
@@ -194,21 +474,18 @@ extern int lengthStack (Stack *S);
 
 /*********************************************************************
  * FUNCTION NAME: topStack
- * PURPOSE: Finds an Item in a Stack.
- * ARGUMENTS: . The position in the Stack where the Item is in (int) 
- *            . The address of the Stack (Stack *L)
+ * PURPOSE: Finds the Item on top of a Stack.
+ * ARGUMENTS: . The address of the Stack (Stack *)
  *            . The address of the Item
  *              the Item found should be copied to
- * REQUIRES: . The position should be a nonnegative integer
- *             lower than the length of the Stack.
- *           . The Stack should not be empty.
+ * REQUIRES: The Stack should not be empty.
  *********************************************************************/
 extern void topStack (Stack *S, Item *X);
 
 /*********************************************************************
  * FUNCTION NAME: destroyStack
  * PURPOSE: Frees memory that may have been allocated
- *          by Initialize, Insert or Delete.
+ *          by Initialize, Reserve or Push.
  * ARGUMENTS: The address of the Stack to be destroyed (Stack *) 
  * NOTES: The last function to be called should always be Destroy. 
  *********************************************************************/
@@ -219,11 +496,83 @@ extern void destroyStack (Stack *S);
  * PURPOSE: Reverses a Stack
  (the first Item becomes the last and vice versa).
  * ARGUMENTS: The address of the Stack to be reversed (Stack *) 
+ * NOTE: Swaps Items in place in O(n) time and no extra memory.
  *********************************************************************/
 extern void reverseStack (Stack *S);
 
 ///////////////////////////////////////////////////////////////////////
 
+// Concurrent Stack Interface
+///////////////////////////////////////////////////////////////////////
+
+/*********************************************************************
+ * A ConcurrentStack is a lock-free Stack that many threads may push
+ * to and pop from at once. Its nodes are allocated up front and
+ * recycled through a free list, so Push and Pop never call the
+ * allocator and a node is never freed while another thread may
+ * still read it.
+ *********************************************************************/
+
+/*********************************************************************
+ * FUNCTION NAME: initializeConcurrentStack
+ * PURPOSE: Sets a ConcurrentStack variable to the empty Concurrent
+ *          Stack that holds at most a number of Items.
+ * ARGUMENTS: . The address of the ConcurrentStack variable to be
+ *              initialized (ConcurrentStack *)
+ *            . The number of Items (int)
+ * REQUIRES: The number of Items should be positive.
+ * RETURNS: True (a nonzero integer) if the Concurrent Stack could be
+ *          initialized, false (0) otherwise
+ * NOTE: Initialize is the only function that may be used right
+ *       after the declaration of the ConcurrentStack variable or a
+ *       call to Destroy, and it should not be used otherwise.
+ *********************************************************************/
+extern int initializeConcurrentStack (ConcurrentStack *C, int capacity);
+
+/*********************************************************************
+ * FUNCTION NAME: pushConcurrentStack
+ * PURPOSE: Inserts an Item on top of a Concurrent Stack.
+ * ARGUMENTS: . The Item to be inserted (Item)
+ *            . The address of the Concurrent Stack (ConcurrentStack *)
+ * RETURNS: True (a nonzero integer) if the Item was inserted,
+ *          false (0) if the Concurrent Stack is full
+ *********************************************************************/
+extern int pushConcurrentStack (Item X, ConcurrentStack *C);
+
+/*********************************************************************
+ * FUNCTION NAME: popConcurrentStack
+ * PURPOSE: Deletes the Item on top of a Concurrent Stack.
+ * ARGUMENTS: . The address of the Concurrent Stack (ConcurrentStack *)
+ *            . The address of the Item
+ *              the Item deleted should be copied to
+ * RETURNS: True (a nonzero integer) if an Item was deleted,
+ *          false (0) if the Concurrent Stack was empty
+ * NOTE: Top and Pop are one call, since another thread may change
+ *       the top between two.
+ *********************************************************************/
+extern int popConcurrentStack (ConcurrentStack *C, Item *X);
+
+/*********************************************************************
+ * FUNCTION NAME: emptyConcurrentStack
+ * PURPOSE: Determines whether a Concurrent Stack is empty.
+ * ARGUMENTS: The address of the Concurrent Stack (ConcurrentStack *)
+ * RETURNS: True (a nonzero integer) if the Concurrent Stack was
+ *          empty when it was looked at, false (0) otherwise
+ *********************************************************************/
+extern int emptyConcurrentStack (ConcurrentStack *C);
+
+/*********************************************************************
+ * FUNCTION NAME: destroyConcurrentStack
+ * PURPOSE: Frees memory that may have been allocated by Initialize.
+ * ARGUMENT: The address of the Concurrent Stack to be destroyed
+ *           (ConcurrentStack *) 
+ * NOTE: The last function to be called should always be Destroy,
+ *       once no other thread uses the Concurrent Stack.
+ *********************************************************************/
+extern void destroyConcurrentStack (ConcurrentStack *C);
+
+///////////////////////////////////////////////////////////////////////
+
 
 // BST Interface
 ///////////////////////////////////////////////////////////////////////
@@ -276,6 +625,41 @@ extern void initializeBST (Tree *T,
 						void (*destroyItem) (void *),
 						int (*compareItems) (void *, void *));
 
+/*********************************************************************
+ * FUNCTION NAME: initializeInlineBST
+ * PURPOSE: Sets a Tree variable to the empty Binary Search Tree
+ *          whose items all have the same size and are stored inside
+ *          the nodes of the Tree instead of being made by a copy
+ *          function.
+ * ARGUMENTS: . The address of the Tree variable to be initialized
+ *              (Tree *) 
+ *            . The size of the items in bytes (size_t)
+ *            . A pointer to a compare function (see Initialize)
+ * REQUIRES: The size of the items should be positive.
+ * NOTES: . Items are copied in and out with memcpy, so they should
+ *          not own memory of their own.
+ *        . Initialize is the only function that may be used right
+ *          after the declaration of the Tree variable or a call
+ *          to Destroy, and it should not be used otherwise.
+ *********************************************************************/
+extern void initializeInlineBST (Tree *T,
+							  size_t itemSize,
+							  int (*compareItems) (void *, void *));
+
+/*********************************************************************
+ * FUNCTION NAME: setAllocatorBST
+ * PURPOSE: Makes a Tree get its memory from an Allocator
+ *          instead of malloc and free.
+ * ARGUMENTS: . The address of the Tree (Tree *)
+ *            . The address of the Allocator (Allocator *),
+ *              or NULL to go back to malloc and free
+ * REQUIRES: The Tree should be empty.
+ * NOTES: If the Allocator has a releaseAll function, Destroy calls
+ *        it instead of releasing the nodes one at a time, so such an
+ *        Allocator should not be shared with another structure.
+ *********************************************************************/
+extern void setAllocatorBST (Tree *T, Allocator *A);
+
 /*********************************************************************
  * FUNCTION NAME: insertBST
  * PURPOSE: Inserts an item in a Binary Search Tree.
@@ -284,6 +668,20 @@ extern void initializeBST (Tree *T,
  *********************************************************************/
 extern void insertBST (Tree *T, void *I);
 
+/*********************************************************************
+ * FUNCTION NAME: buildBST
+ * PURPOSE: Fills an empty Binary Search Tree with sorted items,
+ *          giving it the least possible height, in linear time.
+ * ARGUMENTS: . The address of the Tree (Tree *)
+ *            . An array of the addresses (void **) of the items,
+ *              sorted according to the compare function whose
+ *              address was passed to Initialize
+ *            . The number of items (int)
+ * REQUIRES: . The Tree should be empty.
+ *           . The items should be sorted.
+ *********************************************************************/
+extern void buildBST (Tree *T, void **items, int n);
+
 /*********************************************************************
  * FUNCTION NAME: minimumBST
  * PURPOSE: Finds the least item (according to the compare 
@@ -317,6 +715,118 @@ extern int minimumBST (Tree *T, void *I);
  *********************************************************************/
 extern int successorBST (Tree *T, void *I);
 
+/*********************************************************************
+ * FUNCTION NAME: searchBST
+ * PURPOSE: Finds an item of a Binary Search Tree equal (according
+ *          to the compare function whose address was passed to
+ *          Initialize) to a given item.
+ * ARGUMENTS: . The address of the Tree (Tree *)
+ *            . The address (void *) of the item to be searched for
+ *            . NULL, or the address (void *) where a copy
+ *              of the item found should be stored
+ * RETURNS: 1 if an equal item has been found, 0 otherwise
+ * NOTES: Successor may be called right after a successful Search;
+ *        it then finds the successor of the item found.
+ *********************************************************************/
+extern int searchBST (Tree *T, void *I, void *J);
+
+/*********************************************************************
+ * FUNCTION NAME: selectBST
+ * PURPOSE: Finds the item of a Binary Search Tree that has a given
+ *          position in the order defined by the compare function
+ *          whose address was passed to Initialize.
+ * ARGUMENTS: . The address of the Tree (Tree *)
+ *            . The position of the item, 0 being the position
+ *              of the least item (int)
+ *            . The address (void *) where a copy 
+ *              of the item found should be stored 
+ * RETURNS: 1 if the item has been found, i.e., if the position
+ *          is a nonnegative integer lower than the number of
+ *          items in the Tree, 0 otherwise
+ * NOTES: Successor may be called right after a successful Select.
+ *********************************************************************/
+extern int selectBST (Tree *T, int k, void *I);
+
+/*********************************************************************
+ * FUNCTION NAME: rankBST
+ * PURPOSE: Counts the items of a Binary Search Tree that are less
+ *          (according to the compare function whose address was
+ *          passed to Initialize) than a given item.
+ * ARGUMENTS: . The address of the Tree (Tree *)
+ *            . The address (void *) of the item
+ * RETURNS: The number of items less than the item (int), which is
+ *          the position Select finds it at if it is in the Tree
+ *********************************************************************/
+extern int rankBST (Tree *T, void *I);
+
+/*********************************************************************
+ * FUNCTION NAME: rangeVisitBST
+ * PURPOSE: Passes to a visit function, in increasing order, every
+ *          item of a Binary Search Tree that is neither less than a
+ *          low item nor greater than a high item (according to the
+ *          compare function whose address was passed to Initialize).
+ * ARGUMENTS: . The address of the Tree (Tree *)
+ *            . The address (void *) of the low item
+ *            . The address (void *) of the high item
+ *            . A pointer to a visit function
+ *              -------------------------------
+ *              PURPOSE: Processes an item.
+ *              ARGUMENTS: . The address (void *) of the item inside
+ *                           the Tree, which should not be modified
+ *                         . The context passed to Visit (void *)
+ *              RETURNS: 0 to stop the visit, 1 to go on
+ *              -------------------------------
+ *            . A context for the visit function (void *)
+ * RETURNS: The number of items passed to the visit function (int)
+ * NOTES: . Items are not copied, and the items below the low item
+ *          are skipped in one descent from the root.
+ *        . The visit function should not insert into or delete
+ *          from the Tree.
+ *********************************************************************/
+extern int rangeVisitBST (Tree *T, void *lo, void *hi,
+						int (*visit) (void *, void *), void *context);
+
+/*********************************************************************
+ * FUNCTION NAME: deleteBST
+ * PURPOSE: Removes from a Binary Search Tree an item equal
+ *          (according to the compare function whose address was
+ *          passed to Initialize) to a given item.
+ * ARGUMENTS: . The address of the Tree (Tree *)
+ *            . The address (void *) of the item to be removed
+ * RETURNS: 1 if an equal item has been found and removed,
+ *          0 otherwise
+ * NOTES: If several items are equal, only one of them is removed.
+ *********************************************************************/
+extern int deleteBST (Tree *T, void *I);
+
+/*********************************************************************
+ * FUNCTION NAME: statsBST
+ * PURPOSE: Finds what a Binary Search Tree has done since it was
+ *          initialized.
+ * ARGUMENTS: The address of the Tree (Tree *)
+ * RETURNS: A Statistics structure (Statistics) with the number of
+ *          . comparisons, calls to the compare function
+ *          . allocations and frees, of nodes
+ *          . leftLeftRotations, leftRightRotations,
+ *            rightRightRotations and rightLeftRotations, of an
+ *            AVL Tree, by the side of the taller child and
+ *            grandchild of the node rotated
+ *          . descents, the searches, inserts and deletes that went
+ *            down the Tree, with their totalDepth, so that the
+ *            average depth is totalDepth/descents, and maxDepth
+ * NOTES: . The counts are only kept when DSSTATISTICS is defined
+ *          as the structures are compiled; otherwise they are all
+ *          0, and keeping them costs nothing. As it changes Tree
+ *          and Heap, it should be defined for every file that
+ *          includes DSInterface.h.
+ *        . A maxDepth close to the size of the Tree means it has
+ *          degraded to a path, as with sorted inserts.
+ *        . Only inserts, searches and deletes are counted: cursors,
+ *          ranks and range visits leave the counts alone, so they
+ *          may still run at once on the same Tree.
+ *********************************************************************/
+extern Statistics statsBST (Tree *T);
+
 /*********************************************************************
  * FUNCTION NAME: destroyBST
  * PURPOSE: Frees memory that may have been 
@@ -380,6 +890,41 @@ extern void initializeAVL (Tree *T,
 						void (*destroyItem) (void *),
 						int (*compareItems) (void *, void *));
 
+/*********************************************************************
+ * FUNCTION NAME: initializeInlineAVL
+ * PURPOSE: Sets a Tree variable to the empty Binary Search Tree
+ *          whose items all have the same size and are stored inside
+ *          the nodes of the Tree instead of being made by a copy
+ *          function.
+ * ARGUMENTS: . The address of the Tree variable to be initialized
+ *              (Tree *) 
+ *            . The size of the items in bytes (size_t)
+ *            . A pointer to a compare function (see Initialize)
+ * REQUIRES: The size of the items should be positive.
+ * NOTES: . Items are copied in and out with memcpy, so they should
+ *          not own memory of their own.
+ *        . Initialize is the only function that may be used right
+ *          after the declaration of the Tree variable or a call
+ *          to Destroy, and it should not be used otherwise.
+ *********************************************************************/
+extern void initializeInlineAVL (Tree *T,
+							  size_t itemSize,
+							  int (*compareItems) (void *, void *));
+
+/*********************************************************************
+ * FUNCTION NAME: setAllocatorAVL
+ * PURPOSE: Makes a Tree get its memory from an Allocator
+ *          instead of malloc and free.
+ * ARGUMENTS: . The address of the Tree (Tree *)
+ *            . The address of the Allocator (Allocator *),
+ *              or NULL to go back to malloc and free
+ * REQUIRES: The Tree should be empty.
+ * NOTES: If the Allocator has a releaseAll function, Destroy calls
+ *        it instead of releasing the nodes one at a time, so such an
+ *        Allocator should not be shared with another structure.
+ *********************************************************************/
+extern void setAllocatorAVL (Tree *T, Allocator *A);
+
 /*********************************************************************
  * FUNCTION NAME: insertAVL
  * PURPOSE: Inserts an item in a Binary Search Tree.
@@ -388,6 +933,20 @@ extern void initializeAVL (Tree *T,
  *********************************************************************/
 extern void insertAVL (Tree *T, void *I);
 
+/*********************************************************************
+ * FUNCTION NAME: buildAVL
+ * PURPOSE: Fills an empty Binary Search Tree with sorted items,
+ *          giving it the least possible height, in linear time.
+ * ARGUMENTS: . The address of the Tree (Tree *)
+ *            . An array of the addresses (void **) of the items,
+ *              sorted according to the compare function whose
+ *              address was passed to Initialize
+ *            . The number of items (int)
+ * REQUIRES: . The Tree should be empty.
+ *           . The items should be sorted.
+ *********************************************************************/
+extern void buildAVL (Tree *T, void **items, int n);
+
 /*********************************************************************
  * FUNCTION NAME: minimumAVL
  * PURPOSE: Finds the least item (according to the compare 
@@ -421,6 +980,92 @@ extern int minimumAVL (Tree *T, void *I);
  *********************************************************************/
 extern int successorAVL (Tree *T, void *I);
 
+/*********************************************************************
+ * FUNCTION NAME: searchAVL
+ * PURPOSE: Finds an item of a Binary Search Tree equal (according
+ *          to the compare function whose address was passed to
+ *          Initialize) to a given item.
+ * ARGUMENTS: . The address of the Tree (Tree *)
+ *            . The address (void *) of the item to be searched for
+ *            . NULL, or the address (void *) where a copy
+ *              of the item found should be stored
+ * RETURNS: 1 if an equal item has been found, 0 otherwise
+ * NOTES: Successor may be called right after a successful Search;
+ *        it then finds the successor of the item found.
+ *********************************************************************/
+extern int searchAVL (Tree *T, void *I, void *J);
+
+/*********************************************************************
+ * FUNCTION NAME: selectAVL
+ * PURPOSE: Finds the item of a Binary Search Tree that has a given
+ *          position in the order defined by the compare function
+ *          whose address was passed to Initialize.
+ * ARGUMENTS: . The address of the Tree (Tree *)
+ *            . The position of the item, 0 being the position
+ *              of the least item (int)
+ *            . The address (void *) where a copy 
+ *              of the item found should be stored 
+ * RETURNS: 1 if the item has been found, i.e., if the position
+ *          is a nonnegative integer lower than the number of
+ *          items in the Tree, 0 otherwise
+ * NOTES: Successor may be called right after a successful Select.
+ *********************************************************************/
+extern int selectAVL (Tree *T, int k, void *I);
+
+/*********************************************************************
+ * FUNCTION NAME: rankAVL
+ * PURPOSE: Counts the items of a Binary Search Tree that are less
+ *          (according to the compare function whose address was
+ *          passed to Initialize) than a given item.
+ * ARGUMENTS: . The address of the Tree (Tree *)
+ *            . The address (void *) of the item
+ * RETURNS: The number of items less than the item (int), which is
+ *          the position Select finds it at if it is in the Tree
+ *********************************************************************/
+extern int rankAVL (Tree *T, void *I);
+
+/*********************************************************************
+ * FUNCTION NAME: rangeVisitAVL
+ * PURPOSE: Passes to a visit function, in increasing order, every
+ *          item of a Binary Search Tree that is neither less than a
+ *          low item nor greater than a high item (according to the
+ *          compare function whose address was passed to Initialize).
+ * ARGUMENTS: . The address of the Tree (Tree *)
+ *            . The address (void *) of the low item
+ *            . The address (void *) of the high item
+ *            . A pointer to a visit function
+ *              -------------------------------
+ *              PURPOSE: Processes an item.
+ *              ARGUMENTS: . The address (void *) of the item inside
+ *                           the Tree, which should not be modified
+ *                         . The context passed to Visit (void *)
+ *              RETURNS: 0 to stop the visit, 1 to go on
+ *              -------------------------------
+ *            . A context for the visit function (void *)
+ * RETURNS: The number of items passed to the visit function (int)
+ * NOTES: . Items are not copied, and the items below the low item
+ *          are skipped in one descent from the root.
+ *        . The visit function should not insert into or delete
+ *          from the Tree.
+ *********************************************************************/
+extern int rangeVisitAVL (Tree *T, void *lo, void *hi,
+						int (*visit) (void *, void *), void *context);
+
+/*********************************************************************
+ * FUNCTION NAME: deleteAVL
+ * PURPOSE: Removes from a Binary Search Tree an item equal
+ *          (according to the compare function whose address was
+ *          passed to Initialize) to a given item.
+ * ARGUMENTS: . The address of the Tree (Tree *)
+ *            . The address (void *) of the item to be removed
+ * RETURNS: 1 if an equal item has been found and removed,
+ *          0 otherwise
+ * NOTES: If several items are equal, only one of them is removed.
+ *        The Tree is rebalanced along the path from the removed
+ *        node to the root.
+ *********************************************************************/
+extern int deleteAVL (Tree *T, void *I);
+
 /*********************************************************************
  * FUNCTION NAME: sizeAVL
  * PURPOSE: Finds the number of items stored in a Binary Search Tree.
@@ -443,11 +1088,22 @@ extern int heightAVL (Tree *T);
  * PURPOSE: Checks whether a Binary Search Tree is balanced.
  * ARGUMENT: The address of the Tree (Tree *) 
  * RETURNS: 1 if the Tree is balanced, 0 otherwise
- * NOTES: A Tree is balanced if it is empty or if for any node N
- *        the heights of N's subTrees are equal or differ by 1.
+ * NOTES: . A Tree is balanced if it is empty or if for any node N
+ *          the heights of N's subTrees are equal or differ by 1.
+ *        . Insert keeps the height of every node cached and
+ *          rebalances along the insertion path, so only the
+ *          root has to be checked.
  *********************************************************************/
 extern int balancedAVL (Tree *T);
 
+/*********************************************************************
+ * FUNCTION NAME: statsAVL
+ * PURPOSE: Finds what an AVL Tree has done since it was initialized.
+ * ARGUMENTS: The address of the Tree (Tree *)
+ * RETURNS: A Statistics structure (Statistics) (see statsBST)
+ *********************************************************************/
+extern Statistics statsAVL (Tree *T);
+
 /*********************************************************************
  * FUNCTION NAME: Destroy
  * PURPOSE: Frees memory that may have been 
@@ -460,6 +1116,282 @@ extern void destroyAVL (Tree *T);
 ///////////////////////////////////////////////////////////////////////
 
 
+// Tree Cursor Interface
+///////////////////////////////////////////////////////////////////////
+
+/*********************************************************************
+ * A TreeCursor holds a position in a Binary Search Tree (BST or AVL)
+ * without modifying the Tree, so any number of cursors may traverse
+ * the same Tree at once, as long as nothing inserts into or deletes
+ * from the Tree meanwhile. A cursor is either on an item or off the
+ * Tree.
+ *********************************************************************/
+
+/*********************************************************************
+ * FUNCTION NAME: initializeTreeCursor
+ * PURPOSE: Sets a TreeCursor variable to a cursor off a Tree.
+ * ARGUMENTS: . The address of the TreeCursor variable to be
+ *              initialized (TreeCursor *)
+ *            . The address of the Tree (Tree *)
+ *********************************************************************/
+extern void initializeTreeCursor (TreeCursor *C, Tree *T);
+
+/*********************************************************************
+ * FUNCTION NAME: firstTreeCursor
+ * PURPOSE: Moves a TreeCursor to the least item of its Tree.
+ * ARGUMENTS: The address of the TreeCursor (TreeCursor *)
+ * RETURNS: 1 if the cursor is on an item, i.e., if the Tree is not
+ *          empty, 0 otherwise
+ *********************************************************************/
+extern int firstTreeCursor (TreeCursor *C);
+
+/*********************************************************************
+ * FUNCTION NAME: lastTreeCursor
+ * PURPOSE: Moves a TreeCursor to the greatest item of its Tree.
+ * ARGUMENTS: The address of the TreeCursor (TreeCursor *)
+ * RETURNS: 1 if the cursor is on an item, i.e., if the Tree is not
+ *          empty, 0 otherwise
+ *********************************************************************/
+extern int lastTreeCursor (TreeCursor *C);
+
+/*********************************************************************
+ * FUNCTION NAME: seekTreeCursor
+ * PURPOSE: Moves a TreeCursor to an item of its Tree equal
+ *          (according to the compare function whose address
+ *          was passed to Initialize) to a given item.
+ * ARGUMENTS: . The address of the TreeCursor (TreeCursor *)
+ *            . The address (void *) of the item to be searched for
+ * RETURNS: 1 if an equal item has been found, 0 otherwise, in which
+ *          case the cursor is off the Tree
+ *********************************************************************/
+extern int seekTreeCursor (TreeCursor *C, void *I);
+
+/*********************************************************************
+ * FUNCTION NAME: lowerBoundTreeCursor
+ * PURPOSE: Moves a TreeCursor to the least item of its Tree that is
+ *          not less (according to the compare function whose address
+ *          was passed to Initialize) than a given item.
+ * ARGUMENTS: . The address of the TreeCursor (TreeCursor *)
+ *            . The address (void *) of the item
+ * RETURNS: 1 if such an item has been found, 0 otherwise, in which
+ *          case the cursor is off the Tree
+ *********************************************************************/
+extern int lowerBoundTreeCursor (TreeCursor *C, void *I);
+
+/*********************************************************************
+ * FUNCTION NAME: upperBoundTreeCursor
+ * PURPOSE: Moves a TreeCursor to the least item of its Tree that is
+ *          greater (according to the compare function whose address
+ *          was passed to Initialize) than a given item.
+ * ARGUMENTS: . The address of the TreeCursor (TreeCursor *)
+ *            . The address (void *) of the item
+ * RETURNS: 1 if such an item has been found, 0 otherwise, in which
+ *          case the cursor is off the Tree
+ *********************************************************************/
+extern int upperBoundTreeCursor (TreeCursor *C, void *I);
+
+/*********************************************************************
+ * FUNCTION NAME: nextTreeCursor
+ * PURPOSE: Moves a TreeCursor to the successor of its item.
+ * ARGUMENTS: The address of the TreeCursor (TreeCursor *)
+ * RETURNS: 1 if the cursor is on an item, 0 if it was on the
+ *          greatest item or off the Tree
+ *********************************************************************/
+extern int nextTreeCursor (TreeCursor *C);
+
+/*********************************************************************
+ * FUNCTION NAME: prevTreeCursor
+ * PURPOSE: Moves a TreeCursor to the predecessor of its item.
+ * ARGUMENTS: The address of the TreeCursor (TreeCursor *)
+ * RETURNS: 1 if the cursor is on an item, 0 if it was on the
+ *          least item or off the Tree
+ *********************************************************************/
+extern int prevTreeCursor (TreeCursor *C);
+
+/*********************************************************************
+ * FUNCTION NAME: currentTreeCursor
+ * PURPOSE: Finds the item a TreeCursor is on.
+ * ARGUMENTS: The address of the TreeCursor (TreeCursor *)
+ * RETURNS: The address (void *) of the item inside the Tree, or NULL
+ *          if the cursor is off the Tree
+ * NOTES: The item is not copied; it should not be modified, and its
+ *        address is valid until the item is deleted.
+ *********************************************************************/
+extern void *currentTreeCursor (TreeCursor *C);
+
+///////////////////////////////////////////////////////////////////////
+
+
+// B-Tree Interface
+///////////////////////////////////////////////////////////////////////
+
+/*********************************************************************
+ * A BTree keeps up to BTREEORDER-1 sorted items per node, in nodes
+ * aligned on cache lines, so a search visits few nodes and compares
+ * items lying next to each other in memory.
+ *********************************************************************/
+
+/*********************************************************************
+ * FUNCTION NAME: initializeBTree
+ * PURPOSE: Sets a BTree variable to the empty B-Tree.
+ * ARGUMENTS: . The address of the BTree variable to be initialized
+ *              (BTree *) 
+ *            . A pointer to a copy function (see initializeBST)
+ *            . A pointer to a destroy function (see initializeBST)
+ *            . A pointer to a compare function (see initializeBST)
+ * NOTES: Initialize is the only function that may be used right
+ *        after the declaration of the BTree variable or a call
+ *        to Destroy, and it should not be used otherwise.
+ *********************************************************************/
+extern void initializeBTree (BTree *T,
+						  void * (*copyItem) (void *, void *),
+						  void (*destroyItem) (void *),
+						  int (*compareItems) (void *, void *));
+
+/*********************************************************************
+ * FUNCTION NAME: initializeInlineBTree
+ * PURPOSE: Sets a BTree variable to the empty B-Tree whose items all
+ *          have the same size and are stored inside the nodes.
+ * ARGUMENTS: . The address of the BTree variable to be initialized
+ *              (BTree *) 
+ *            . The size of the items in bytes (size_t)
+ *            . A pointer to a compare function (see initializeBST)
+ * REQUIRES: The size of the items should be positive.
+ * NOTES: . Items are copied in and out with memcpy, so they should
+ *          not own memory of their own.
+ *        . Initialize is the only function that may be used right
+ *          after the declaration of the BTree variable or a call
+ *          to Destroy, and it should not be used otherwise.
+ *********************************************************************/
+extern void initializeInlineBTree (BTree *T,
+								size_t itemSize,
+								int (*compareItems) (void *, void *));
+
+/*********************************************************************
+ * FUNCTION NAME: setAllocatorBTree
+ * PURPOSE: Makes a BTree get its memory from an Allocator
+ *          instead of aligned_alloc and free.
+ * ARGUMENTS: . The address of the BTree (BTree *)
+ *            . The address of the Allocator (Allocator *),
+ *              or NULL to go back to aligned_alloc and free
+ * REQUIRES: The BTree should be empty.
+ * NOTES: . Nodes are only aligned on cache lines if the Allocator
+ *          aligns them.
+ *        . If the Allocator has a releaseAll function, Destroy calls
+ *          it instead of releasing the nodes one at a time, so such
+ *          an Allocator should not be shared with another structure.
+ *********************************************************************/
+extern void setAllocatorBTree (BTree *T, Allocator *A);
+
+/*********************************************************************
+ * FUNCTION NAME: insertBTree
+ * PURPOSE: Inserts an item in a B-Tree.
+ * ARGUMENTS: . The address of the BTree (BTree *)
+ *            . The address of the item to be inserted (void *)
+ *********************************************************************/
+extern void insertBTree (BTree *T, void *I);
+
+/*********************************************************************
+ * FUNCTION NAME: searchBTree
+ * PURPOSE: Finds an item of a B-Tree equal (according to the compare
+ *          function whose address was passed to Initialize) to a
+ *          given item.
+ * ARGUMENTS: . The address of the BTree (BTree *)
+ *            . The address (void *) of the item to be searched for
+ *            . NULL, or the address (void *) where a copy
+ *              of the item found should be stored
+ * RETURNS: 1 if an equal item has been found, 0 otherwise
+ *********************************************************************/
+extern int searchBTree (BTree *T, void *I, void *J);
+
+/*********************************************************************
+ * FUNCTION NAME: deleteBTree
+ * PURPOSE: Removes from a B-Tree an item equal (according to the
+ *          compare function whose address was passed to Initialize)
+ *          to a given item.
+ * ARGUMENTS: . The address of the BTree (BTree *)
+ *            . The address (void *) of the item to be removed
+ * RETURNS: 1 if an equal item has been found and removed,
+ *          0 otherwise
+ * NOTES: If several items are equal, only one of them is removed.
+ *********************************************************************/
+extern int deleteBTree (BTree *T, void *I);
+
+/*********************************************************************
+ * FUNCTION NAME: sizeBTree
+ * PURPOSE: Finds the number of items stored in a B-Tree.
+ * ARGUMENT: The address of the BTree (BTree *) 
+ * RETURNS: The number of items stored in the BTree
+ *********************************************************************/
+extern int sizeBTree (BTree *T);
+
+/*********************************************************************
+ * FUNCTION NAME: destroyBTree
+ * PURPOSE: Frees memory that may have been 
+ *          allocated by Initialize and Insert.
+ * ARGUMENTS: The address of the BTree to be destroyed (BTree *) 
+ * NOTES: The last function to be called should always be Destroy. 
+ *********************************************************************/
+extern void destroyBTree (BTree *T);
+
+/*********************************************************************
+ * A BTreeCursor holds a position in a B-Tree without modifying it,
+ * like a TreeCursor does in a Tree.
+ *********************************************************************/
+
+/*********************************************************************
+ * FUNCTION NAME: initializeBTreeCursor
+ * PURPOSE: Sets a BTreeCursor variable to a cursor off a B-Tree.
+ * ARGUMENTS: . The address of the BTreeCursor variable to be
+ *              initialized (BTreeCursor *)
+ *            . The address of the BTree (BTree *)
+ *********************************************************************/
+extern void initializeBTreeCursor (BTreeCursor *C, BTree *T);
+
+/*********************************************************************
+ * FUNCTION NAME: firstBTreeCursor
+ * PURPOSE: Moves a BTreeCursor to the least item of its B-Tree.
+ * ARGUMENTS: The address of the BTreeCursor (BTreeCursor *)
+ * RETURNS: 1 if the cursor is on an item, i.e., if the BTree is not
+ *          empty, 0 otherwise
+ *********************************************************************/
+extern int firstBTreeCursor (BTreeCursor *C);
+
+/*********************************************************************
+ * FUNCTION NAME: lowerBoundBTreeCursor
+ * PURPOSE: Moves a BTreeCursor to the least item of its B-Tree that
+ *          is not less (according to the compare function whose
+ *          address was passed to Initialize) than a given item.
+ * ARGUMENTS: . The address of the BTreeCursor (BTreeCursor *)
+ *            . The address (void *) of the item
+ * RETURNS: 1 if such an item has been found, 0 otherwise, in which
+ *          case the cursor is off the BTree
+ *********************************************************************/
+extern int lowerBoundBTreeCursor (BTreeCursor *C, void *I);
+
+/*********************************************************************
+ * FUNCTION NAME: nextBTreeCursor
+ * PURPOSE: Moves a BTreeCursor to the successor of its item.
+ * ARGUMENTS: The address of the BTreeCursor (BTreeCursor *)
+ * RETURNS: 1 if the cursor is on an item, 0 if it was on the
+ *          greatest item or off the BTree
+ *********************************************************************/
+extern int nextBTreeCursor (BTreeCursor *C);
+
+/*********************************************************************
+ * FUNCTION NAME: currentBTreeCursor
+ * PURPOSE: Finds the item a BTreeCursor is on.
+ * ARGUMENTS: The address of the BTreeCursor (BTreeCursor *)
+ * RETURNS: The address (void *) of the item inside the BTree, or
+ *          NULL if the cursor is off the BTree
+ * NOTES: The item is not copied; it should not be modified, and its
+ *        address is valid until the next insertion or deletion.
+ *********************************************************************/
+extern void *currentBTreeCursor (BTreeCursor *C);
+
+///////////////////////////////////////////////////////////////////////
+
+
 // Heap Interface
 ///////////////////////////////////////////////////////////////////////
 
@@ -468,7 +1400,7 @@ extern void destroyAVL (Tree *T);
  * PURPOSE: Sets a Heap variable to the empty Heap.
  * ARGUMENTS: . The address of the Heap variable to be initialized
  *              (Heap *) 
- *			  . The requested capacity for the Heap (int)
+ *			  . The initial capacity for the Heap (int)
  *            . A pointer to a copy function
  *              ---------------------------- 
  *              PURPOSE: Makes a copy of an item.
@@ -516,16 +1448,157 @@ extern int initializeHeap (Heap *H,
 					   void (*destroyItem) (void *),
 					   int (*compareItems) (void *, void *));
 
+/*********************************************************************
+ * FUNCTION NAME: initializeInlineHeap
+ * PURPOSE: Sets a Heap variable to the empty Heap whose items all
+ *          have the same size and are stored in its array.
+ * ARGUMENTS: . The address of the Heap variable to be initialized
+ *              (Heap *) 
+ *			  . The initial capacity for the Heap (int)
+ *            . The size of the items in bytes (size_t)
+ *            . A pointer to a compare function (see initializeHeap)
+ * REQUIRES: The size of the items should be positive.
+ * RETURNS: True (a nonzero integer) if the Heap could be initialized,
+ *		    false (0) otherwise
+ * NOTES: . Items are copied in and out with memcpy, so they should
+ *          not own memory of their own.
+ *        . Initialize is the only function that may be used right
+ *          after the declaration of the Heap variable or a call
+ *          to Destroy, and it should not be used otherwise.
+ *********************************************************************/
+extern int initializeInlineHeap (Heap *H,
+							 int capacity,
+							 size_t itemSize,
+							 int (*compareItems) (void *, void *));
+
+/*********************************************************************
+ * FUNCTION NAME: setAllocatorHeap
+ * PURPOSE: Makes a Heap get the memory for its array from an
+ *          Allocator instead of aligned_alloc and free.
+ * ARGUMENTS: . The address of the Heap (Heap *)
+ *            . The address of the Allocator (Allocator *),
+ *              or NULL to go back to malloc and free
+ * REQUIRES: The Heap should be empty.
+ * RETURNS: True (a nonzero integer) if the array could be allocated,
+ *		    false (0) otherwise, in which case the Heap is unchanged
+ * NOTES: . The items themselves are still made by the copy
+ *          function.
+ *        . The array grows to blocks of any size, so a Pool does
+ *          not suit it: with one, an insert that needs more room
+ *          than the Heap was initialized with returns false.
+ *********************************************************************/
+extern int setAllocatorHeap (Heap *H, Allocator *A);
+
+/*********************************************************************
+ * FUNCTION NAME: reserveHeap
+ * PURPOSE: Makes room in a Heap for a number of items, so that
+ *          Insert does not have to grow it until that many items
+ *          are stored.
+ * ARGUMENTS: . The address of the Heap (Heap *)
+ *            . The number of items (int)
+ * RETURNS: True (a nonzero integer) if the room could be made,
+ *		    false (0) otherwise, in which case the Heap is unchanged
+ *********************************************************************/
+extern int reserveHeap (Heap *H, int capacity);
+
+/*********************************************************************
+ * FUNCTION NAME: shrinkHeap
+ * PURPOSE: Frees the room of a Heap that no item uses.
+ * ARGUMENT: The address of the Heap (Heap *)
+ * RETURNS: True (a nonzero integer) if the room could be freed,
+ *		    false (0) otherwise, in which case the Heap is unchanged
+ * ENSURES: Full will return true (a nonzero integer).
+ *********************************************************************/
+extern int shrinkHeap (Heap *H);
+
+/*********************************************************************
+ * FUNCTION NAME: setArityHeap
+ * PURPOSE: Sets the number of children of each node of a Heap.
+ * ARGUMENTS: . The address of the Heap (Heap *)
+ *            . The number of children (int), 2 by default
+ * REQUIRES: The Heap should be empty, and the number at least 2.
+ * NOTE: More children make the Heap shallower, so Remove compares
+ *       more items on fewer levels. Without an Allocator the
+ *       children of a node share a cache line when their number
+ *       times the size of a slot (a pointer, or an inline item)
+ *       divides 64, and start one when it equals 64, as with 8
+ *       pointers or 4 items of 16 bytes.
+ *********************************************************************/
+extern void setArityHeap (Heap *H, int arity);
+
+/*********************************************************************
+ * FUNCTION NAME: setBoundHeap
+ * PURPOSE: Makes a Heap keep only the largest items inserted in it,
+ *          up to a number of them, so that it can select the best
+ *          items of a stream of any length in bounded memory.
+ * ARGUMENTS: . The address of the Heap (Heap *)
+ *            . The number of items to keep (int), or 0 to keep all
+ * REQUIRES: The Heap should be empty and not indexed.
+ * RETURNS: True (a nonzero integer) if room could be made for the
+ *          items, false (0) otherwise
+ * NOTE: A bounded Heap is ordered the other way round: Top and
+ *       Remove find the smallest item kept, which an item must
+ *       beat to get in once the Heap holds the bound.
+ *********************************************************************/
+extern int setBoundHeap (Heap *H, int bound);
+
+/*********************************************************************
+ * FUNCTION NAME: setIndexedHeap
+ * PURPOSE: Makes a Heap give each inserted item a handle, through
+ *          which the item can later be updated or removed.
+ * ARGUMENT: The address of the Heap (Heap *)
+ * REQUIRES: The Heap should be empty and not bounded.
+ * RETURNS: True (a nonzero integer) if the handles could be
+ *          allocated, false (0) otherwise, in which case the
+ *          Heap is unchanged
+ *********************************************************************/
+extern int setIndexedHeap (Heap *H);
+
 /*********************************************************************
  * FUNCTION NAME: insertHeap
  * PURPOSE: Inserts an item in a Heap.
  * ARGUMENTS: . The address of the Heap (Heap *)
  *            . The address of the item to be inserted (void *)
- * RETURNS: True (a nonzero integer) if the item could be inserted,
- *		    false (0) otherwise
+ * RETURNS: The handle (a positive integer) of the item if the Heap
+ *          is indexed, true (a nonzero integer) if it is not, and
+ *		    false (0) if the item could not be inserted
+ * NOTES: . A full Heap doubles its capacity first. A handle stays
+ *          valid until its item is removed, after which it may be
+ *          handed out again.
+ *        . A bounded Heap that holds the bound drops the item, or
+ *          its smallest one to make room for it.
  *********************************************************************/
 extern int insertHeap (Heap *H, void *I);
 
+/*********************************************************************
+ * FUNCTION NAME: insertBatchHeap
+ * PURPOSE: Inserts several items in a Heap, heapifying it again
+ *          instead of sifting each item up when the batch is at
+ *          least as large as the Heap.
+ * ARGUMENTS: . The address of the Heap (Heap *)
+ *            . An array of the addresses (void **) of the items
+ *            . The number of items (int)
+ * RETURNS: True (a nonzero integer) if the items could be inserted,
+ *		    false (0) otherwise, in which case an unbounded Heap
+ *          is unchanged
+ * NOTE: In an indexed Heap the items get handles, which are not
+ *       returned.
+ *********************************************************************/
+extern int insertBatchHeap (Heap *H, void **items, int n);
+
+/*********************************************************************
+ * FUNCTION NAME: buildHeap
+ * PURPOSE: Fills an empty Heap with items in linear time.
+ * ARGUMENTS: . The address of the Heap (Heap *)
+ *            . An array of the addresses (void **) of the items
+ *            . The number of items (int)
+ * REQUIRES: The Heap should be empty.
+ * RETURNS: True (a nonzero integer) if the items could be inserted,
+ *		    false (0) otherwise, in which case the Heap stays empty
+ * NOTE: In an indexed Heap, the ith item gets handle i+1.
+ *********************************************************************/
+extern int buildHeap (Heap *H, void **items, int n);
+
 /*********************************************************************
  * FUNCTION NAME: removeHeap
  * PURPOSE: Removes the largest item from a Heap.
@@ -533,6 +1606,46 @@ extern int insertHeap (Heap *H, void *I);
  *********************************************************************/
 extern void removeHeap (Heap *H);
 
+/*********************************************************************
+ * FUNCTION NAME: popBatchHeap
+ * PURPOSE: Removes the largest items from a Heap, largest first,
+ *          and hands them over without copying them.
+ * ARGUMENTS: . The address of the Heap (Heap *)
+ *            . The address of an array for the items: of k item
+ *              addresses (void **), which the caller then owns and
+ *              frees with the destroy function, or of k items for
+ *              an inline Heap
+ *            . The number of items to remove (int)
+ * RETURNS: The number of items removed, which is less than k if
+ *          the Heap runs out
+ * NOTE: A bounded Heap hands over its smallest items first.
+ *********************************************************************/
+extern int popBatchHeap (Heap *H, void *out, int k);
+
+/*********************************************************************
+ * FUNCTION NAME: updateKeyHeap
+ * PURPOSE: Replaces an item of an indexed Heap with a larger or
+ *          smaller one, in O(log n) time.
+ * ARGUMENTS: . The address of the Heap (Heap *)
+ *            . The handle of the item (int)
+ *            . The address of the new item (void *)
+ * REQUIRES: The handle was returned by Insert and its item has
+ *           not been removed.
+ * NOTE: The new item is copied over the old one, with the copy
+ *       function or memcpy for inline items, and keeps the handle.
+ *********************************************************************/
+extern void updateKeyHeap (Heap *H, int handle, void *I);
+
+/*********************************************************************
+ * FUNCTION NAME: removeAtHeap
+ * PURPOSE: Removes any item of an indexed Heap, in O(log n) time.
+ * ARGUMENTS: . The address of the Heap (Heap *)
+ *            . The handle of the item (int)
+ * REQUIRES: The handle was returned by Insert and its item has
+ *           not been removed.
+ *********************************************************************/
+extern void removeAtHeap (Heap *H, int handle);
+
 /*********************************************************************
  * FUNCTION NAME: topHeap
  * PURPOSE: Finds the largest item in a Heap.
@@ -548,6 +1661,7 @@ extern void topHeap (Heap *H, void *I);
  * ARGUMENT: The address of the Heap (Heap *) 
  * RETURNS: True (a nonzero integer) if the Heap is full,
  *          false (0) otherwise
+ * NOTE: Insert grows a full Heap.
  *********************************************************************/
 extern int fullHeap (Heap *H);
 
@@ -560,6 +1674,21 @@ extern int fullHeap (Heap *H);
  *********************************************************************/
 extern int emptyHeap (Heap *H);
 
+/*********************************************************************
+ * FUNCTION NAME: statsHeap
+ * PURPOSE: Finds what a Heap has done since it was initialized.
+ * ARGUMENTS: The address of the Heap (Heap *)
+ * RETURNS: A Statistics structure (Statistics) (see statsBST) with
+ *          the number of
+ *          . comparisons, calls to the compare function
+ *          . allocations and frees, of the array and of the copies
+ *            of the items
+ *          . siftSteps, the levels items moved up or down by
+ *            Insert, Remove and the other functions that sift
+ *          and the other counts 0
+ *********************************************************************/
+extern Statistics statsHeap (Heap *H);
+
 /*********************************************************************
  * FUNCTION NAME: destroyHeap
  * PURPOSE: Frees memory that may have been 
@@ -569,4 +1698,83 @@ extern int emptyHeap (Heap *H);
  *********************************************************************/
 extern void destroyHeap (Heap *H);
 
-///////////////////////////////////////////////////////////////////////
\ No newline at end of file
+/*********************************************************************
+ * FUNCTION NAME: heapSort
+ * PURPOSE: Sorts an array of items in place, in increasing order
+ *          according to a compare function, in O(n log n) time.
+ * ARGUMENTS: . An array of the addresses (void **) of the items
+ *            . The number of items (int)
+ *            . A pointer to a compare function (see initializeHeap)
+ * NOTE: The sort is not stable, and only the addresses are moved.
+ *********************************************************************/
+extern void heapSort (void **items, int n, int (*compareItems) (void *, void *));
+
+///////////////////////////////////////////////////////////////////////
+
+// Concurrent Heap Interface
+///////////////////////////////////////////////////////////////////////
+
+/*********************************************************************
+ * FUNCTION NAME: initializeConcurrentHeap
+ * PURPOSE: Sets a ConcurrentHeap variable to the empty Concurrent
+ *          Heap, a priority queue that many threads may use at once.
+ * ARGUMENTS: . The address of the ConcurrentHeap variable to be
+ *              initialized (ConcurrentHeap *)
+ *            . The number of Heaps it is made of, each behind its
+ *              own lock (int)
+ *            . A pointer to a copy function (see initializeHeap)
+ *            . A pointer to a destroy function (see initializeHeap)
+ *            . A pointer to a compare function (see initializeHeap)
+ * REQUIRES: The number of Heaps should be positive.
+ * RETURNS: True (a nonzero integer) if the Concurrent Heap could be
+ *          initialized, false (0) otherwise
+ * NOTES: . Insert goes to a random Heap, and Remove takes the
+ *          larger top of two random Heaps, so the item removed is
+ *          close to, but not always, the largest. One Heap makes
+ *          it exact; two to four per thread spread the locking
+ *          enough for most uses.
+ *        . Initialize is the only function that may be used right
+ *          after the declaration of the ConcurrentHeap variable or
+ *          a call to Destroy, and it should not be used otherwise.
+ *********************************************************************/
+extern int initializeConcurrentHeap (ConcurrentHeap *C,
+								int numberOfQueues,
+								void * (*copyItem) (void *, void *),
+								void (*destroyItem) (void *),
+								int (*compareItems) (void *, void *));
+
+/*********************************************************************
+ * FUNCTION NAME: insertConcurrentHeap
+ * PURPOSE: Inserts an item in a Concurrent Heap.
+ * ARGUMENTS: . The address of the Concurrent Heap (ConcurrentHeap *)
+ *            . The address of the item to be inserted (void *)
+ * RETURNS: True (a nonzero integer) if the item could be inserted,
+ *		    false (0) otherwise
+ *********************************************************************/
+extern int insertConcurrentHeap (ConcurrentHeap *C, void *I);
+
+/*********************************************************************
+ * FUNCTION NAME: removeConcurrentHeap
+ * PURPOSE: Removes one of the largest items from a Concurrent Heap.
+ * ARGUMENTS: . The address of the Concurrent Heap (ConcurrentHeap *)
+ *            . The address where a copy of the item removed
+ *              should be stored
+ * RETURNS: True (a nonzero integer) if an item was removed,
+ *          false (0) if the Concurrent Heap was empty
+ * NOTE: An item inserted by another thread while Remove runs may
+ *       be missed.
+ *********************************************************************/
+extern int removeConcurrentHeap (ConcurrentHeap *C, void *I);
+
+/*********************************************************************
+ * FUNCTION NAME: destroyConcurrentHeap
+ * PURPOSE: Frees memory that may have been 
+ *          allocated by Initialize and Insert.
+ * ARGUMENT: The address of the Concurrent Heap to be destroyed
+ *           (ConcurrentHeap *) 
+ * NOTE: The last function to be called should always be Destroy,
+ *       once no other thread uses the Concurrent Heap.
+ *********************************************************************/
+extern void destroyConcurrentHeap (ConcurrentHeap *C);
+
+///////////////////////////////////////////////////////////////////////
@@ -0,0 +1,479 @@
+/*********************************************************************
+ * FILE NAME: DSTemplate.h
+ * PURPOSE: Type-specialized data structure definitions.
+ *********************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+/*********************************************************************
+ * The structures of DSInterface.h store one Item type, or reach
+ * their items through void pointers and compare them through a
+ * function pointer the compiler cannot see through. The macros below
+ * instead define a structure and its functions for one type, stored
+ * by value and compared by a function or macro the compiler can
+ * inline, so that several types may be used in one program and the
+ * inner loops compile to plain code.
+ *
+ * Each macro takes:
+ *   . name, the name of the structure it defines, which is also
+ *     appended to the names of its functions, as in insertIntHeap
+ *     for the name IntHeap
+ *   . type, the type of the items, which are copied by assignment
+ *   . compare (a, b), a function or macro of two items that returns
+ *     a negative integer if a comes before b, 0 if they are equal
+ *     and a positive integer otherwise
+ * and should be used once per name, at file scope. The functions
+ * are static inline, so a header may use the macros and be included
+ * by several files. They get their memory from malloc and free.
+ *********************************************************************/
+
+#define TEMPLATECHUNKSIZE 16
+
+// Heap Template
+///////////////////////////////////////////////////////////////////////
+
+/*********************************************************************
+ * MACRO NAME: DS_DEFINE_HEAP
+ * PURPOSE: Defines a binary Heap of items of a type, with the
+ *          largest item (according to compare) on top.
+ * DEFINES: . void initializename (name *H)
+ *          . int reservename (name *H, int capacity)
+ *          . int insertname (name *H, type X), 0 if out of memory
+ *          . void removename (name *H)
+ *          . void topname (name *H, type *X)
+ *          . int emptyname (name *H)
+ *          . int lengthname (name *H)
+ *          . void destroyname (name *H)
+ *          which work as the Heap functions of the same names.
+ *********************************************************************/
+#define DS_DEFINE_HEAP(name, type, compare) \
+typedef struct { \
+	type *items; \
+	int capacity; \
+	int numberOfItems; \
+} name; \
+\
+static inline void initialize##name (name *H) { \
+	H->items=NULL; \
+	H->capacity=0; \
+	H->numberOfItems=0; \
+} \
+\
+static inline int reserve##name (name *H, int capacity) { \
+	type *items; \
+	 \
+	if(capacity<=H->capacity) return 1; \
+	items=realloc(H->items,sizeof(type)*((size_t)capacity+1)); \
+	if(items==NULL) return 0; \
+	H->items=items; \
+	H->capacity=capacity; \
+	return 1; \
+} \
+\
+static inline int insert##name (name *H, type X) { \
+	int child, parent; \
+	 \
+	if(H->numberOfItems==H->capacity && !reserve##name(H,2*H->capacity+1)) return 0; \
+	child=++H->numberOfItems; \
+	while(child>1 && compare(X,H->items[parent=child/2])>0) { \
+		H->items[child]=H->items[parent]; \
+		child=parent; \
+	} \
+	H->items[child]=X; \
+	return 1; \
+} \
+\
+static inline void remove##name (name *H) { \
+	type last; \
+	int parent=1, child, n; \
+	 \
+	assert(H->numberOfItems > 0); \
+	last=H->items[H->numberOfItems--]; \
+	n=H->numberOfItems; \
+	while((child=2*parent)<=n) { \
+		if(child<n && compare(H->items[child+1],H->items[child])>0) child++; \
+		if(compare(H->items[child],last)<=0) break; \
+		H->items[parent]=H->items[child]; \
+		parent=child; \
+	} \
+	H->items[parent]=last; \
+} \
+\
+static inline void top##name (name *H, type *X) { \
+	assert(H->numberOfItems > 0); \
+	*X=H->items[1]; \
+} \
+\
+static inline int empty##name (name *H) { \
+	return H->numberOfItems==0; \
+} \
+\
+static inline int length##name (name *H) { \
+	return H->numberOfItems; \
+} \
+\
+static inline void destroy##name (name *H) { \
+	free(H->items); \
+}
+
+///////////////////////////////////////////////////////////////////////
+
+
+// AVL Tree Template
+///////////////////////////////////////////////////////////////////////
+
+/*********************************************************************
+ * MACRO NAME: DS_DEFINE_AVL
+ * PURPOSE: Defines an AVL Tree of items of a type, ordered by
+ *          compare, with equal items allowed.
+ * DEFINES: . void initializename (name *T)
+ *          . int insertname (name *T, type X), 0 if out of memory
+ *          . int searchname (name *T, type X, type *Y)
+ *          . int minimumname (name *T, type *X)
+ *          . int deletename (name *T, type X)
+ *          . int sizename (name *T)
+ *          . int heightname (name *T)
+ *          . void destroyname (name *T)
+ *          which work as the AVL functions of the same names.
+ *********************************************************************/
+#define DS_DEFINE_AVL(name, type, compare) \
+typedef struct name##NodeTag { \
+	type item; \
+	struct name##NodeTag *left, *right; \
+	int height; \
+} name##Node; \
+\
+typedef struct { \
+	name##Node *root; \
+	int size; \
+} name; \
+\
+static inline int height##name##Node (name##Node *N) { \
+	return N==NULL ? -1 : N->height; \
+} \
+\
+static inline void update##name##Node (name##Node *N) { \
+	int hleft=height##name##Node(N->left), hright=height##name##Node(N->right); \
+	N->height=1+(hleft<hright ? hright : hleft); \
+} \
+\
+/* Rotates N with its left child if left is nonzero, or with its \
+ * right child otherwise, and returns the new root of the subtree. */ \
+static inline name##Node *rotate##name (name##Node *N, int left) { \
+	name##Node *C; \
+	 \
+	if(left) { \
+		C=N->left; \
+		N->left=C->right; \
+		C->right=N; \
+	} else { \
+		C=N->right; \
+		N->right=C->left; \
+		C->left=N; \
+	} \
+	update##name##Node(N); \
+	update##name##Node(C); \
+	return C; \
+} \
+\
+/* Rebalances the subtree of N after one of its children changed \
+ * height by one, and returns its root. */ \
+static inline name##Node *rebalance##name (name##Node *N) { \
+	int b; \
+	 \
+	update##name##Node(N); \
+	b=height##name##Node(N->left)-height##name##Node(N->right); \
+	if(b>1) { \
+		if(height##name##Node(N->left->left)<height##name##Node(N->left->right)) \
+			N->left=rotate##name(N->left,0); \
+		return rotate##name(N,1); \
+	} \
+	if(b<-1) { \
+		if(height##name##Node(N->right->right)<height##name##Node(N->right->left)) \
+			N->right=rotate##name(N->right,1); \
+		return rotate##name(N,0); \
+	} \
+	return N; \
+} \
+\
+static inline name##Node *insert##name##Node (name##Node *N, name##Node *M) { \
+	if(N==NULL) return M; \
+	if(compare(M->item,N->item)<0) N->left=insert##name##Node(N->left,M); \
+	else N->right=insert##name##Node(N->right,M); \
+	return rebalance##name(N); \
+} \
+\
+/* Deletes the least node of the subtree of N, which *M is set to, \
+ * and returns the root of what is left. */ \
+static inline name##Node *deleteMinimum##name##Node (name##Node *N, name##Node **M) { \
+	if(N->left==NULL) { \
+		*M=N; \
+		return N->right; \
+	} \
+	N->left=deleteMinimum##name##Node(N->left,M); \
+	return rebalance##name(N); \
+} \
+\
+static inline name##Node *delete##name##Node (name##Node *N, type X, int *deleted) { \
+	name##Node *M; \
+	int c; \
+	 \
+	if(N==NULL) return NULL; \
+	c=compare(X,N->item); \
+	if(c<0) N->left=delete##name##Node(N->left,X,deleted); \
+	else if(c>0) N->right=delete##name##Node(N->right,X,deleted); \
+	else { \
+		*deleted=1; \
+		M=N; \
+		if(N->right==NULL) N=N->left; \
+		else { \
+			M->right=deleteMinimum##name##Node(M->right,&N); \
+			N->left=M->left; \
+			N->right=M->right; \
+		} \
+		free(M); \
+		if(N==NULL) return NULL; \
+	} \
+	return rebalance##name(N); \
+} \
+\
+static inline void destroy##name##Node (name##Node *N) { \
+	if(N==NULL) return; \
+	destroy##name##Node(N->left); \
+	destroy##name##Node(N->right); \
+	free(N); \
+} \
+\
+static inline void initialize##name (name *T) { \
+	T->root=NULL; \
+	T->size=0; \
+} \
+\
+static inline int insert##name (name *T, type X) { \
+	name##Node *M; \
+	 \
+	M=malloc(sizeof(name##Node)); \
+	if(M==NULL) return 0; \
+	M->item=X; \
+	M->left=NULL; \
+	M->right=NULL; \
+	M->height=0; \
+	T->root=insert##name##Node(T->root,M); \
+	T->size++; \
+	return 1; \
+} \
+\
+static inline int search##name (name *T, type X, type *Y) { \
+	name##Node *N=T->root; \
+	int c; \
+	 \
+	while(N!=NULL) { \
+		c=compare(X,N->item); \
+		if(c==0) { \
+			*Y=N->item; \
+			return 1; \
+		} \
+		N=c<0 ? N->left : N->right; \
+	} \
+	return 0; \
+} \
+\
+static inline int minimum##name (name *T, type *X) { \
+	name##Node *N=T->root; \
+	 \
+	if(N==NULL) return 0; \
+	while(N->left!=NULL) N=N->left; \
+	*X=N->item; \
+	return 1; \
+} \
+\
+static inline int delete##name (name *T, type X) { \
+	int deleted=0; \
+	 \
+	T->root=delete##name##Node(T->root,X,&deleted); \
+	T->size-=deleted; \
+	return deleted; \
+} \
+\
+static inline int size##name (name *T) { \
+	return T->size; \
+} \
+\
+static inline int height##name (name *T) { \
+	return height##name##Node(T->root); \
+} \
+\
+static inline void destroy##name (name *T) { \
+	destroy##name##Node(T->root); \
+}
+
+///////////////////////////////////////////////////////////////////////
+
+
+// Linked-List Template
+///////////////////////////////////////////////////////////////////////
+
+/*********************************************************************
+ * MACRO NAME: DS_DEFINE_LIST
+ * PURPOSE: Defines a List of items of a type, stored, as in List,
+ *          in a doubly-linked list of chunks of up to
+ *          TEMPLATECHUNKSIZE items.
+ * ARGUMENTS: name and type only; a List needs no compare.
+ * DEFINES: . void initializename (name *L)
+ *          . int insertname (type X, int position, name *L),
+ *            0 if out of memory
+ *          . int appendname (type X, name *L), 0 if out of memory
+ *          . void deletename (int position, name *L)
+ *          . void peekname (int position, name *L, type *X)
+ *          . int emptyname (name *L)
+ *          . int lengthname (name *L)
+ *          . void destroyname (name *L)
+ *          which work as the List functions of the same names.
+ *********************************************************************/
+#define DS_DEFINE_LIST(name, type) \
+typedef struct name##ChunkTag { \
+	struct name##ChunkTag *next, *prev; \
+	int count; \
+	type items[TEMPLATECHUNKSIZE]; \
+} name##Chunk; \
+\
+typedef struct { \
+	int size; \
+	name##Chunk *first; \
+	name##Chunk *last; \
+} name; \
+\
+/* Finds the chunk that holds a position from whichever end of the \
+ * List is closer, and the offset of the position in it. */ \
+static inline name##Chunk *move##name##To (int position, name *L, int *offset) { \
+	name##Chunk *c; \
+	int start; \
+	 \
+	start=L->size-L->last->count; \
+	if(position>=start) { \
+		*offset=position-start; \
+		return L->last; \
+	} \
+	if(position<=L->size/2) { \
+		for(c=L->first;position>=c->count;c=c->next) position-=c->count; \
+		*offset=position; \
+		return c; \
+	} \
+	for(c=L->last;position<start;start-=c->count) c=c->prev; \
+	*offset=position-start; \
+	return c; \
+} \
+\
+/* Links a new empty chunk in after c, or first if c is NULL. */ \
+static inline name##Chunk *new##name##Chunk (name##Chunk *c, name *L) { \
+	name##Chunk *d; \
+	 \
+	d=malloc(sizeof(name##Chunk)); \
+	if(d==NULL) return NULL; \
+	d->count=0; \
+	d->prev=c; \
+	d->next=c==NULL ? L->first : c->next; \
+	if(d->next!=NULL) d->next->prev=d; \
+	else L->last=d; \
+	if(c!=NULL) c->next=d; \
+	else L->first=d; \
+	return d; \
+} \
+\
+static inline void free##name##Chunk (name##Chunk *c, name *L) { \
+	if(c->prev!=NULL) c->prev->next=c->next; \
+	else L->first=c->next; \
+	if(c->next!=NULL) c->next->prev=c->prev; \
+	else L->last=c->prev; \
+	free(c); \
+} \
+\
+static inline void initialize##name (name *L) { \
+	L->size=0; \
+	L->first=NULL; \
+	L->last=NULL; \
+} \
+\
+static inline int insert##name (type X, int position, name *L) { \
+	name##Chunk *c, *d; \
+	int offset, half; \
+	 \
+	assert(position >= 0 && position <= L->size); \
+	if(L->first==NULL) { \
+		if((c=new##name##Chunk(NULL,L))==NULL) return 0; \
+		offset=0; \
+	} \
+	else c=move##name##To(position,L,&offset); \
+	if(c->count==TEMPLATECHUNKSIZE) { \
+		if((d=new##name##Chunk(c,L))==NULL) return 0; \
+		if(offset==TEMPLATECHUNKSIZE) { \
+			c=d; \
+			offset=0; \
+		} else { \
+			half=TEMPLATECHUNKSIZE/2; \
+			memcpy(d->items,c->items+half,sizeof(type)*(TEMPLATECHUNKSIZE-half)); \
+			d->count=TEMPLATECHUNKSIZE-half; \
+			c->count=half; \
+			if(offset>half) { \
+				c=d; \
+				offset-=half; \
+			} \
+		} \
+	} \
+	memmove(c->items+offset+1,c->items+offset,sizeof(type)*(c->count-offset)); \
+	c->items[offset]=X; \
+	c->count++; \
+	L->size++; \
+	return 1; \
+} \
+\
+static inline int append##name (type X, name *L) { \
+	return insert##name(X,L->size,L); \
+} \
+\
+static inline void delete##name (int position, name *L) { \
+	name##Chunk *c, *d; \
+	int offset; \
+	 \
+	assert(position >= 0 && position < L->size); \
+	c=move##name##To(position,L,&offset); \
+	memmove(c->items+offset,c->items+offset+1,sizeof(type)*(c->count-offset-1)); \
+	c->count--; \
+	L->size--; \
+	if(c->count==0) free##name##Chunk(c,L); \
+	else if(c->count<TEMPLATECHUNKSIZE/2) { \
+		if(c->next!=NULL && c->count+c->next->count<=TEMPLATECHUNKSIZE) d=c->next; \
+		else if(c->prev!=NULL && c->prev->count+c->count<=TEMPLATECHUNKSIZE) { \
+			d=c; \
+			c=c->prev; \
+		} \
+		else return; \
+		memcpy(c->items+c->count,d->items,sizeof(type)*d->count); \
+		c->count+=d->count; \
+		free##name##Chunk(d,L); \
+	} \
+} \
+\
+static inline void peek##name (int position, name *L, type *X) { \
+	name##Chunk *c; \
+	int offset; \
+	 \
+	assert(position >= 0 && position < L->size); \
+	c=move##name##To(position,L,&offset); \
+	*X=c->items[offset]; \
+} \
+\
+static inline int empty##name (name *L) { \
+	return L->size==0; \
+} \
+\
+static inline int length##name (name *L) { \
+	return L->size; \
+} \
+\
+static inline void destroy##name (name *L) { \
+	while(L->first!=NULL) free##name##Chunk(L->first,L); \
+}
+
+///////////////////////////////////////////////////////////////////////
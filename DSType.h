@@ -6,47 +6,169 @@
 // Chenge to item ----------> #include "ItemInterface.h"
 // Chenge to item ----------> typedef Object Item;
 
+#include <stddef.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdatomic.h>
 
-#define MAXLISTSIZE 4
+typedef struct {
+	void * (*allocate) (void *, size_t);
+	void (*release) (void *, void *);
+	void (*releaseAll) (void *);
+	void *context;
+} Allocator;
 
-typedef struct ListNodeTag {
-	Item item;
-	struct ListNodeTag *next;
-} ListNode;
+typedef struct {
+	size_t objectSize;
+	int objectsPerPage;
+	void *pages;
+	void *freeObjects;
+	char *next;
+	int remaining;
+	Allocator allocator;
+} Pool;
+
+typedef struct {
+	long comparisons;
+	long allocations;
+	long frees;
+	long leftLeftRotations;
+	long leftRightRotations;
+	long rightRightRotations;
+	long rightLeftRotations;
+	long siftSteps;
+	long descents;
+	long totalDepth;
+	int maxDepth;
+} Statistics;
+
+#define LISTCHUNKSIZE 16
+#define BTREEORDER 16
+#define BTREEDEPTH 32
+#define CACHELINE 64
+
+// A chunk of a doubly-linked List is allocated with room for one Item.
+typedef struct ListChunkTag {
+	struct ListChunkTag *next, *prev;
+	int count;
+	Item items[LISTCHUNKSIZE];
+} ListChunk;
 
 typedef struct {
 	int size;
-	ListNode *first;
+	ListChunk *first;
+	ListChunk *last;
+	int chunkCapacity;
+	Allocator *allocator;
 } List;
 
+typedef struct {
+	List *list;
+	ListChunk *chunk;
+	int index;
+} ListCursor;
+
 typedef struct TreeNodeTag {
 	void *item;
 	struct TreeNodeTag *left, *right, *parent;
+	int height;
+	int size;
 } TreeNode;
 
 typedef struct {
 	TreeNode *root;
 	TreeNode *current;
+	int size;
+	size_t itemSize;
+	Allocator *allocator;
 	void * (*copyItem) (void *, void *);
 	void (*destroyItem) (void *);
 	int (*compareItems) (void *, void *);
+#ifdef DSSTATISTICS
+	Statistics statistics;
+#endif
 } Tree;
 
 typedef struct {
-	void **heap;
+	Tree *tree;
+	TreeNode *node;
+} TreeCursor;
+
+// A B-Tree node is followed by its items, then by its children.
+typedef struct BTreeNodeTag {
+	int numberOfItems;
+	int leaf;
+} BTreeNode;
+
+typedef struct {
+	BTreeNode *root;
+	int size;
+	size_t itemSize;
+	size_t slotSize;
+	size_t childrenOffset;
+	size_t nodeSize;
+	Allocator *allocator;
+	void * (*copyItem) (void *, void *);
+	void (*destroyItem) (void *);
+	int (*compareItems) (void *, void *);
+} BTree;
+
+typedef struct {
+	BTree *tree;
+	int depth;
+	BTreeNode *nodes[BTREEDEPTH];
+	int indexes[BTREEDEPTH];
+} BTreeCursor;
+
+typedef struct {
+	char *heap;
+	size_t itemSize;
+	size_t slotSize;
+	int arity;
+	int bound;
+	int order;
+	int *handles;
+	int *positions;
+	int handleCapacity;
+	int numberOfHandles;
+	int freeHandle;
 	int capacity;
 	int numberOfItems;
+	Allocator *allocator;
 	void * (*copyItem) (void *, void *);
 	void (*destroyItem) (void *);
 	int (*compareItems) (void *, void *);
+#ifdef DSSTATISTICS
+	Statistics statistics;
+#endif
 } Heap;
 
-typedef struct StackNodeTag {
-	Item item;
-	struct StackNodeTag *next;
-} StackNode;
+typedef struct {
+	_Alignas(CACHELINE) pthread_mutex_t lock;
+	Heap heap;
+} LockedHeap;
 
 typedef struct {
+	LockedHeap *queues;
+	int numberOfQueues;
+} ConcurrentHeap;
+
+typedef struct {
+	Item *items;
 	int size;
-	StackNode *first;
-} Stack;
\ No newline at end of file
+	int capacity;
+	int bounded;
+	Allocator *allocator;
+} Stack;
+
+typedef struct {
+	Item item;
+	_Atomic uint32_t next;
+} ConcurrentStackNode;
+
+typedef struct {
+	_Alignas(CACHELINE) _Atomic uint64_t top;
+	_Alignas(CACHELINE) _Atomic uint64_t free;
+	ConcurrentStackNode *nodes;
+	int capacity;
+} ConcurrentStack;
\ No newline at end of file